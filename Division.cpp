@@ -0,0 +1,374 @@
+/** @file Division.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Division of limb arrays, in three tiers:
+1. a divisor of one or two limbs is handled by divrem_1 or divrem_2, which divide with a precomputed reciprocal
+   instead of a hardware division per limb, and shift the dividend on the fly, so they need no scratch space;
+2. short divisors (or short quotients) use schoolbook division (Knuth's Algorithm D), again with reciprocals;
+3. long divisors use Burnikel-Ziegler recursive division, which turns the work into multiplications, so it speeds
+   up along with multiplication (Karatsuba, Toom-3, NTT).
+
+The reciprocal-based steps follow Moller and Granlund, "Improved division by invariant integers" (2011).
+*/
+
+#include "LimbBuffer.h"
+#include "Limbs.h"
+#include <algorithm>
+
+namespace limbs {
+
+namespace {
+
+typedef unsigned __int128 dlimb_t; // Two limbs
+
+/** Counts the leading zero bits of a nonzero limb */
+inline unsigned leading_zeros(limb_t x) {
+	return static_cast<unsigned>(__builtin_clzll(x));
+}
+
+/** Computes the reciprocal floor((2^128 - 1) / d) - 2^64 of a normalized limb (top bit set)
+	@param d the divisor
+	@return the reciprocal
+*/
+inline limb_t invert_limb(limb_t d) {
+	return (limb_t)((((dlimb_t)~d) << 64 | ~limb_t(0)) / d);
+}
+
+/** Divides the two-limb number u1:u0 by a normalized limb d, using its reciprocal v (requires u1 < d)
+	@param r receives the remainder
+	@return the quotient
+*/
+inline limb_t div_2by1(limb_t& r, limb_t u1, limb_t u0, limb_t d, limb_t v) {
+	dlimb_t q = (dlimb_t)v * u1;
+	q += ((dlimb_t)(u1 + 1) << 64) | u0;
+	limb_t q1 = (limb_t)(q >> 64);
+	limb_t q0 = (limb_t)q;
+	limb_t rem = u0 - q1 * d;
+	if (rem > q0) {
+		--q1;
+		rem += d;
+	}
+	if (rem >= d) {
+		++q1;
+		rem -= d;
+	}
+	r = rem;
+	return q1;
+}
+
+/** Computes the reciprocal of a normalized two-limb divisor d1:d0 (for div_3by2)
+	@param d1 the high limb (top bit set)
+	@param d0 the low limb
+	@return floor((2^192 - 1) / (d1:d0)) - 2^64
+*/
+inline limb_t invert_2limbs(limb_t d1, limb_t d0) {
+	limb_t v = invert_limb(d1);
+	limb_t p = d1 * v + d0;
+	if (p < d0) {
+		--v;
+		if (p >= d1) {
+			--v;
+			p -= d1;
+		}
+		p -= d1;
+	}
+	dlimb_t t = (dlimb_t)d0 * v;
+	limb_t t1 = (limb_t)(t >> 64);
+	limb_t t0 = (limb_t)t;
+	p += t1;
+	if (p < t1) {
+		--v;
+		if (p > d1 || (p == d1 && t0 >= d0)) {
+			--v;
+		}
+	}
+	return v;
+}
+
+/** Divides the three-limb number u2:u1:u0 by the normalized two-limb number d1:d0 (requires u2:u1 < d1:d0)
+	@param r receives the two-limb remainder
+	@return the quotient limb
+*/
+inline limb_t div_3by2(dlimb_t& r, limb_t u2, limb_t u1, limb_t u0, limb_t d1, limb_t d0, limb_t v) {
+	dlimb_t d = ((dlimb_t)d1 << 64) | d0;
+	dlimb_t q = (dlimb_t)v * u2 + (((dlimb_t)u2 << 64) | u1);
+	limb_t q1 = (limb_t)(q >> 64);
+	limb_t q0 = (limb_t)q;
+	limb_t r1 = u1 - q1 * d1;
+	dlimb_t rem = (((dlimb_t)r1 << 64) | u0) - d - (dlimb_t)d0 * q1;
+	++q1;
+	if ((limb_t)(rem >> 64) >= q0) {
+		--q1;
+		rem += d;
+	}
+	if (rem >= d) {
+		++q1;
+		rem -= d;
+	}
+	r = rem;
+	return q1;
+}
+
+/** Returns the smallest divisor length that is divided recursively (schoolbook division needs at least two limbs) */
+inline std::size_t recursion_threshold() {
+	return std::max<std::size_t>(thresholds.div_burnikel_ziegler, 4);
+}
+
+/** Schoolbook division (Knuth's Algorithm D) of u by a normalized divisor d
+	@param q receives the low un - dn limbs of the quotient
+	@param u the dividend (un limbs); the remainder is left in u[0, dn)
+	@param d the divisor (dn >= 2 limbs, top bit set)
+	@return the high quotient limb (0 or 1): 1 if the top dn limbs of u were at least d
+*/
+limb_t div_basecase(limb_t* q, limb_t* u, std::size_t un, const limb_t* d, std::size_t dn) {
+	std::size_t qn = un - dn;
+	limb_t qh = 0;
+	if (cmp_n(u + qn, d, dn) >= 0) { // Keeps the invariant that the top dn limbs are below d
+		sub_n(u + qn, u + qn, d, dn);
+		qh = 1;
+	}
+
+	limb_t d1 = d[dn - 1];
+	limb_t d0 = d[dn - 2];
+	limb_t v = invert_2limbs(d1, d0);
+	for (std::size_t j = qn; j-- > 0;) {
+		limb_t* w = u + j; // Window of dn + 1 limbs; its top dn limbs are below d
+		limb_t u2 = w[dn];
+		limb_t u1 = w[dn - 1];
+		limb_t qhat;
+		if (u2 == d1 && u1 == d0) { // The estimate would overflow; B - 1 is at most one too large
+			qhat = ~limb_t(0);
+			limb_t borrow = submul_1(w, d, dn, qhat);
+			w[dn] -= borrow;
+		}
+		else {
+			dlimb_t rem;
+			qhat = div_3by2(rem, u2, u1, w[dn - 2], d1, d0, v);
+			// The top three limbs are done exactly; the rest of d is subtracted below them
+			limb_t borrow = submul_1(w, d, dn - 2, qhat);
+			limb_t r0 = (limb_t)rem;
+			limb_t r1 = (limb_t)(rem >> 64);
+			limb_t carry = (r0 < borrow);
+			r0 -= borrow;
+			limb_t carry2 = (r1 < carry);
+			r1 -= carry;
+			w[dn - 2] = r0;
+			w[dn - 1] = r1;
+			w[dn] = 0;
+			if (carry2) { // qhat was one too large
+				--qhat;
+				add_n(w, w, d, dn);
+			}
+			q[j] = qhat;
+			continue;
+		}
+		while (w[dn] != 0) { // Add back while the window is negative
+			--qhat;
+			w[dn] += add_n(w, w, d, dn);
+		}
+		q[j] = qhat;
+	}
+	return qh;
+}
+
+/** Divides an array by a two-limb divisor, normalizing on the fly (no scratch space)
+	@param q receives a / d (n - 1 limbs)
+	@param r receives a % d (2 limbs)
+	@param a the dividend (n >= 2 limbs)
+	@param d the divisor (2 limbs, top limb nonzero)
+*/
+void divrem_2(limb_t* q, limb_t* r, const limb_t* a, std::size_t n, const limb_t* d) {
+	unsigned s = leading_zeros(d[1]);
+	limb_t d1 = (s == 0) ? d[1] : (d[1] << s) | (d[0] >> (64 - s));
+	limb_t d0 = d[0] << s;
+	limb_t v = invert_2limbs(d1, d0);
+
+	// Limb i of a * 2^s (i <= n); its top two limbs are below d1:d0, since the top one is below 2^s <= d1
+	auto shifted = [a, n, s](std::size_t i) -> limb_t {
+		limb_t high = (i == n) ? 0 : a[i] << s;
+		limb_t low = (s == 0 || i == 0) ? 0 : a[i - 1] >> (64 - s);
+		return high | low;
+	};
+	dlimb_t rem = ((dlimb_t)shifted(n) << 64) | shifted(n - 1);
+	for (std::size_t j = n - 1; j-- > 0;) {
+		q[j] = div_3by2(rem, (limb_t)(rem >> 64), (limb_t)rem, shifted(j), d1, d0, v);
+	}
+	rem >>= s;
+	r[0] = (limb_t)rem;
+	r[1] = (limb_t)(rem >> 64);
+}
+
+/** Burnikel-Ziegler division of 2n limbs by n limbs
+	@param q receives the low n limbs of the quotient
+	@param u the dividend (2n limbs); the remainder is left in u[0, n)
+	@param d the divisor (n limbs, top bit set)
+	@param scratch n limbs of working space
+	@return the high quotient limb (0 or 1)
+
+	The high half of the quotient comes from dividing the top limbs of u by the top half of d, and is then corrected
+	for the low half of d with one multiplication; the low half of the quotient is found the same way.
+*/
+limb_t div_recursive(limb_t* q, limb_t* u, const limb_t* d, std::size_t n, limb_t* scratch) {
+	if (n < recursion_threshold()) {
+		return div_basecase(q, u, 2 * n, d, n);
+	}
+	std::size_t lo = n / 2;
+	std::size_t hi = n - lo;
+
+	limb_t qh = div_recursive(q + lo, u + 2 * lo, d + lo, hi, scratch);
+	mul(scratch, q + lo, hi, d, lo);
+	limb_t borrow = sub_n(u + lo, u + lo, scratch, n);
+	if (qh != 0) {
+		borrow += sub_n(u + n, u + n, d, lo);
+	}
+	while (borrow != 0) { // The estimate was too large: decrease it and add d back
+		qh -= sub_1(q + lo, q + lo, hi, 1);
+		borrow -= add_n(u + lo, u + lo, d, n);
+	}
+
+	limb_t ql = div_recursive(q, u + hi, d + hi, lo, scratch);
+	mul(scratch, d, hi, q, lo);
+	borrow = sub_n(u, u, scratch, n);
+	if (ql != 0) {
+		borrow += sub_n(u + lo, u + lo, d, hi);
+	}
+	while (borrow != 0) {
+		sub_1(q, q, lo, 1);
+		borrow -= add_n(u, u, d, n);
+	}
+	return qh;
+}
+
+/** Divides a window of dn + b limbs by d when the quotient (b limbs) is shorter than d
+	@param q receives the b quotient limbs
+	@param u the window (dn + b limbs); the remainder is left in u[0, dn)
+	@param d the divisor (dn limbs, top bit set)
+
+	The quotient is estimated from the top 2b limbs of u and the top b limbs of d, then corrected by comparing
+	the full product with u.
+*/
+void div_short_quotient(limb_t* q, limb_t* u, std::size_t dn, std::size_t b, const limb_t* d) {
+	LimbBuffer top(u + dn - b, u + dn + b);
+	LimbBuffer scratch(b);
+	limb_t qh = div_recursive(q, top.data(), d + dn - b, b, scratch.data());
+
+	// product = (qh*B^b + q) * d
+	LimbBuffer product(dn + b + 1, 0);
+	mul(product.data(), d, dn, q, b);
+	if (qh != 0) {
+		add(product.data() + b, product.data() + b, dn + 1, d, dn);
+	}
+
+	while (cmp(product.data(), dn + b + 1, u, dn + b) > 0) { // Estimate too large
+		qh -= sub_1(q, q, b, 1);
+		sub(product.data(), product.data(), dn + b + 1, d, dn);
+	}
+	sub(u, u, dn + b, product.data(), dn + b);
+	while (cmp(u, dn + b, d, dn) >= 0) { // Estimate too small
+		add_1(q, q, b, 1);
+		sub(u, u, dn + b, d, dn);
+	}
+}
+
+/** Divides u by a normalized divisor d of at least two limbs, choosing the algorithm from the sizes
+	@param q receives the un - dn quotient limbs
+	@param u the dividend (un limbs, with u < d * B^(un - dn)); the remainder is left in u[0, dn)
+	@param d the divisor (dn limbs, top bit set)
+*/
+void div_normalized(limb_t* q, limb_t* u, std::size_t un, const limb_t* d, std::size_t dn) {
+	std::size_t qn = un - dn;
+	std::size_t threshold = recursion_threshold();
+	if (dn < threshold || qn < threshold) {
+		div_basecase(q, u, un, d, dn);
+		return;
+	}
+
+	// The quotient is produced from the top in blocks of dn limbs (the first block may be shorter)
+	LimbBuffer scratch(dn);
+	std::size_t b = qn % dn;
+	if (b == 0) {
+		b = dn;
+	}
+	std::size_t pos = qn - b;
+	if (b == dn) {
+		div_recursive(q + pos, u + pos, d, dn, scratch.data());
+	}
+	else if (b < threshold) {
+		div_basecase(q + pos, u + pos, dn + b, d, dn);
+	}
+	else {
+		div_short_quotient(q + pos, u + pos, dn, b, d);
+	}
+	while (pos > 0) {
+		pos -= dn;
+		div_recursive(q + pos, u + pos, d, dn, scratch.data());
+	}
+}
+
+} // namespace
+
+/** Divides an array by a single limb
+	@param q receives a / d (n limbs); may be a
+	@param a the dividend (n limbs)
+	@param d the divisor (nonzero)
+	@return the remainder a % d
+*/
+limb_t divrem_1(limb_t* q, const limb_t* a, std::size_t n, limb_t d) {
+	if (n == 0) {
+		return 0;
+	}
+	unsigned s = leading_zeros(d);
+	limb_t dn = d << s;
+	limb_t v = invert_limb(dn);
+
+	// Divides a * 2^s by d * 2^s, shifting the limbs of a on the fly
+	limb_t r = (s == 0) ? 0 : a[n - 1] >> (64 - s);
+	for (std::size_t i = n; i-- > 0;) {
+		limb_t next = (s == 0 || i == 0) ? 0 : a[i - 1] >> (64 - s);
+		limb_t u0 = (a[i] << s) | next;
+		q[i] = div_2by1(r, r, u0, dn, v);
+	}
+	return r >> s;
+}
+
+/** Divides two arrays
+	@param q receives a / d (n - m + 1 limbs)
+	@param r receives a % d (m limbs)
+	@param a the dividend (n limbs, n >= m)
+	@param d the divisor (m limbs, top limb nonzero)
+
+	q and r must not overlap a, d or each other.
+*/
+void divrem(limb_t* q, limb_t* r, const limb_t* a, std::size_t n, const limb_t* d, std::size_t m) {
+	if (m == 1) {
+		r[0] = divrem_1(q, a, n, d[0]);
+		return;
+	}
+	if (m == 2) {
+		divrem_2(q, r, a, n, d);
+		return;
+	}
+
+	// Normalize: shift both operands so that the top bit of d is set (u gets an extra limb for the spill)
+	unsigned s = leading_zeros(d[m - 1]);
+	LimbBuffer dn(d, d + m);
+	LimbBuffer u(a, a + n);
+	u.push_back(0);
+	if (s != 0) {
+		lshift(dn.data(), dn.data(), m, s);
+		u[n] = lshift(u.data(), u.data(), n, s);
+	}
+
+	div_normalized(q, u.data(), n + 1, dn.data(), m);
+
+	// Undo the normalization on the remainder
+	if (s == 0) {
+		std::copy(u.begin(), u.begin() + m, r);
+	}
+	else {
+		rshift(r, u.data(), m, s);
+	}
+}
+
+} // namespace limbs
\ No newline at end of file
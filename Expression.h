@@ -0,0 +1,367 @@
+/** @file Expression.h
+	@brief Contains the expression templates that fuse sums of products of Integers and Fractions
+	@author Aviva Prins
+	@date 10/18/2026
+
+	a * b does not multiply right away: it returns a Product that refers to a and b. Adding or subtracting Products
+	and values gives a Sum of up to a few terms, and the whole sum is computed when it is assigned (or converted) to
+	the value type, so that
+	1. a*b + c*d, a*b - c, x += a*b and x -= a*b build one result buffer instead of a temporary for each product;
+	2. the sum of Fraction products is normalized once, instead of once per operation;
+	3. dot(first1, last1, first2) computes the sum of the products of two ranges in the same way.
+
+	Anything else (comparing, printing, dividing, or passing to a function that takes the value type) computes the
+	Sum first. A Sum only refers to its operands, so it must not outlive them: do not store one with auto
+	(write Integer x = a * b; not auto x = a * b;), and call eval() where the value type is needed explicitly.
+
+	Each value type says how to compute a Sum by specializing expression::Evaluate; the default does the
+	arithmetic term by term.
+*/
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+namespace expression {
+
+/** @struct Term
+	@brief One term of a Sum: a * b, or just a if b is null; negated if negative is true.
+*/
+template<typename T>
+struct Term {
+	const T* a;
+	const T* b;
+	bool negative;
+};
+
+/** Computes the sum of the terms one operation at a time (no fusion)
+	@param dst receives the sum (the terms never refer to dst)
+	@param terms
+	@param n the number of terms
+*/
+template<typename T>
+void accumulate(T& dst, const Term<T>* terms, std::size_t n) {
+	dst = T(0);
+	for (std::size_t i = 0; i < n; ++i) {
+		T x = *terms[i].a;
+		if (terms[i].b) {
+			x *= *terms[i].b;
+		}
+		if (terms[i].negative) {
+			dst -= x;
+		}
+		else {
+			dst += x;
+		}
+	}
+}
+
+/** Computes sums of terms; value types specialize this to fuse the computation
+*/
+template<typename T>
+struct Evaluate {
+	static void sum(T& dst, const Term<T>* terms, std::size_t n) {
+		accumulate(dst, terms, n);
+	}
+};
+
+/** @class Sum
+	@brief A sum of N terms, computed when it is converted to T.
+*/
+template<typename T, std::size_t N>
+class Sum {
+public:
+	typedef T value_type;
+
+	std::array<Term<T>, N> terms;
+
+	/** Computes the sum
+		@return the value of the expression
+	*/
+	T eval() const {
+		T result;
+		Evaluate<T>::sum(result, terms.data(), N);
+		return result;
+	}
+
+	operator T() const { // Computes the sum where a T is needed
+		return eval();
+	}
+};
+
+template<typename T>
+using Product = Sum<T, 1>; // a * b
+
+/** Makes the Product a * b
+	@param a
+	@param b
+	@return an expression for a * b
+*/
+template<typename T>
+Product<T> product(const T& a, const T& b) {
+	return Product<T>{{{{&a, &b, false}}}};
+}
+
+// Joins the terms of two sums, negating the second sum's terms if subtract is true
+template<typename T, std::size_t N, std::size_t M>
+Sum<T, N + M> join(const Sum<T, N>& x, const Sum<T, M>& y, bool subtract) {
+	Sum<T, N + M> result;
+	for (std::size_t i = 0; i < N; ++i) {
+		result.terms[i] = x.terms[i];
+	}
+	for (std::size_t i = 0; i < M; ++i) {
+		result.terms[N + i] = y.terms[i];
+		result.terms[N + i].negative = (y.terms[i].negative != subtract);
+	}
+	return result;
+}
+
+// A single value as a one-term sum
+template<typename T>
+Sum<T, 1> term(const T& a, bool negative) {
+	return Sum<T, 1>{{{{&a, nullptr, negative}}}};
+}
+
+/** Adds two expressions
+	@param x
+	@param y
+	@return an expression for x + y
+*/
+template<typename T, std::size_t N, std::size_t M>
+Sum<T, N + M> operator+(const Sum<T, N>& x, const Sum<T, M>& y) {
+	return join(x, y, false);
+}
+
+/** Subtracts two expressions
+	@param x
+	@param y
+	@return an expression for x - y
+*/
+template<typename T, std::size_t N, std::size_t M>
+Sum<T, N + M> operator-(const Sum<T, N>& x, const Sum<T, M>& y) {
+	return join(x, y, true);
+}
+
+/** Adds a value to an expression (the value's type is taken from the expression, so it may be converted)
+	@param x
+	@param y
+	@return an expression for x + y
+*/
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator+(const Sum<T, N>& x, const typename Sum<T, N>::value_type& y) {
+	return join(x, term(y, false), false);
+}
+
+/** Subtracts a value from an expression
+	@param x
+	@param y
+	@return an expression for x - y
+*/
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator-(const Sum<T, N>& x, const typename Sum<T, N>::value_type& y) {
+	return join(x, term(y, false), true);
+}
+
+/** Adds an expression to a value
+	@param x
+	@param y
+	@return an expression for x + y
+*/
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator+(const typename Sum<T, N>::value_type& x, const Sum<T, N>& y) {
+	return join(term(x, false), y, false);
+}
+
+/** Subtracts an expression from a value
+	@param x
+	@param y
+	@return an expression for x - y
+*/
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator-(const typename Sum<T, N>::value_type& x, const Sum<T, N>& y) {
+	return join(term(x, false), y, true);
+}
+
+// The same for temporary values (which the value type's own operators would otherwise match as well)
+
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator+(const Sum<T, N>& x, typename Sum<T, N>::value_type&& y) {
+	return join(x, term(y, false), false);
+}
+
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator-(const Sum<T, N>& x, typename Sum<T, N>::value_type&& y) {
+	return join(x, term(y, false), true);
+}
+
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator+(typename Sum<T, N>::value_type&& x, const Sum<T, N>& y) {
+	return join(term(x, false), y, false);
+}
+
+template<typename T, std::size_t N>
+Sum<T, N + 1> operator-(typename Sum<T, N>::value_type&& x, const Sum<T, N>& y) {
+	return join(term(x, false), y, true);
+}
+
+/** Negates an expression
+	@param x
+	@return an expression for -x
+*/
+template<typename T, std::size_t N>
+Sum<T, N> operator-(const Sum<T, N>& x) {
+	Sum<T, N> result = x;
+	for (Term<T>& t : result.terms) {
+		t.negative = !t.negative;
+	}
+	return result;
+}
+
+// Products, quotients and remainders of an expression are computed from its value
+
+template<typename T, std::size_t N>
+T operator*(const Sum<T, N>& x, const typename Sum<T, N>::value_type& y) {
+	T result = x.eval();
+	result *= y;
+	return result;
+}
+
+template<typename T, std::size_t N>
+T operator*(const typename Sum<T, N>::value_type& x, const Sum<T, N>& y) {
+	T result = y.eval();
+	result *= x;
+	return result;
+}
+
+template<typename T, std::size_t N, std::size_t M>
+T operator*(const Sum<T, N>& x, const Sum<T, M>& y) {
+	T result = x.eval();
+	result *= y.eval();
+	return result;
+}
+
+template<typename T, std::size_t N>
+T operator/(const Sum<T, N>& x, const typename Sum<T, N>::value_type& y) {
+	T result = x.eval();
+	result /= y;
+	return result;
+}
+
+template<typename T, std::size_t N>
+T operator/(const typename Sum<T, N>::value_type& x, const Sum<T, N>& y) {
+	T result = x;
+	result /= y.eval();
+	return result;
+}
+
+template<typename T, std::size_t N>
+T operator%(const Sum<T, N>& x, const typename Sum<T, N>::value_type& y) {
+	T result = x.eval();
+	result %= y;
+	return result;
+}
+
+/** @struct is_sum
+	@brief True for the expression types
+*/
+template<typename X>
+struct is_sum : std::false_type {};
+
+template<typename T, std::size_t N>
+struct is_sum<Sum<T, N>> : std::true_type {};
+
+// Comparisons with an expression on either side (or both) compare the values
+
+template<typename T>
+const T& value(const T& x) {
+	return x;
+}
+
+template<typename T, std::size_t N>
+T value(const Sum<T, N>& x) {
+	return x.eval();
+}
+
+template<typename L, typename R>
+using enable_comparison = typename std::enable_if<is_sum<L>::value || is_sum<R>::value, bool>::type;
+
+template<typename L, typename R>
+enable_comparison<L, R> operator==(const L& x, const R& y) {
+	return value(x) == value(y);
+}
+
+template<typename L, typename R>
+enable_comparison<L, R> operator!=(const L& x, const R& y) {
+	return value(x) != value(y);
+}
+
+template<typename L, typename R>
+enable_comparison<L, R> operator<(const L& x, const R& y) {
+	return value(x) < value(y);
+}
+
+template<typename L, typename R>
+enable_comparison<L, R> operator>(const L& x, const R& y) {
+	return value(x) > value(y);
+}
+
+template<typename L, typename R>
+enable_comparison<L, R> operator<=(const L& x, const R& y) {
+	return value(x) <= value(y);
+}
+
+template<typename L, typename R>
+enable_comparison<L, R> operator>=(const L& x, const R& y) {
+	return value(x) >= value(y);
+}
+
+/** Output operator <<: prints the value of the expression
+	@param out
+	@param x
+	@return out
+*/
+template<typename T, std::size_t N>
+std::ostream& operator<<(std::ostream& out, const Sum<T, N>& x) {
+	return out << x.eval();
+}
+
+} // namespace expression
+
+/** Dot product: the sum of first1[i] * first2[i], computed as one fused sum
+	@param first1 start of the first range
+	@param last1 end of the first range
+	@param first2 start of the second range (at least as long as the first)
+	@return the sum of the products (zero for an empty range)
+	The products are only evaluated after the whole range has been visited, from pointers to the elements, so both
+	ranges must be forward ranges whose elements are lvalues (not proxies or values made on each dereference).
+*/
+template<typename ForwardIt1, typename ForwardIt2>
+typename std::iterator_traits<ForwardIt1>::value_type dot(ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2) {
+	typedef typename std::iterator_traits<ForwardIt1>::value_type T;
+	static_assert(std::is_lvalue_reference<typename std::iterator_traits<ForwardIt1>::reference>::value &&
+			std::is_lvalue_reference<typename std::iterator_traits<ForwardIt2>::reference>::value &&
+			std::is_same<typename std::iterator_traits<ForwardIt2>::value_type, T>::value,
+		"dot needs iterators that dereference to lvalues of one type");
+	static_assert(std::is_base_of<std::forward_iterator_tag,
+			typename std::iterator_traits<ForwardIt1>::iterator_category>::value &&
+			std::is_base_of<std::forward_iterator_tag,
+			typename std::iterator_traits<ForwardIt2>::iterator_category>::value,
+		"dot needs forward iterators (it keeps pointers to the elements until the end)");
+	std::vector<expression::Term<T>> terms;
+	for (; first1 != last1; ++first1, ++first2) {
+		const T& a = *first1;
+		const T& b = *first2;
+		terms.push_back(expression::Term<T>{&a, &b, false});
+	}
+	T result;
+	expression::Evaluate<T>::sum(result, terms.data(), terms.size());
+	return result;
+}
+
+#endif //Ends the include guard
@@ -4,15 +4,143 @@
  *  @date 12/27/2018
  * 
  *  The fractions are stored in reduced form.
- *  TODO: consider converting to and from double and other things involving decimals
+ *  By default every operation leaves its result reduced. Fraction<F, LazyReduce<>> skips the reduction in the
+ *  arithmetic operators instead, and reduces when the value is compared or printed, when canonicalize() is called,
+ *  or when the numerator or denominator grows past a size limit.
+ *  Observing a lazy value reduces it in place, so even its const members write to it: call canonicalize() on a lazy
+ *  value before sharing it between threads (reduced values are only read).
+ *  When F is not a built-in type (such as Integer), a * b is an expression (see Expression.h): sums of products
+ *  such as a*b + c*d, x += a*b and dot(first1, last1, first2) are computed with a single reduction at the end.
+ *  Fraction<F>(0.1) is the exact value of the double 0.1 (read from its bits); f.to_double() is the nearest double to
+ *  f; and f.limit_denominator(1000) is the closest fraction to f with a denominator of at most 1000.
+ *  std::hash<Fraction<F>> hashes the reduced form, so Fractions can be keys of unordered containers (and of the
+ *  InternTable in InternTable.h).
  */
 
 #ifndef FRACTION_H
 #define FRACTION_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "Expression.h"
+#include "Gcd.h"
+#include "Words.h"
+
+/** Reduction policy: every operation leaves the fraction reduced (the default)
+ */
+struct EagerReduce {
+	static const bool lazy = false;
+	static const std::size_t max_bits = 0;
+};
+
+/** Reduction policy: arithmetic leaves the fraction unreduced until it is observed, canonicalize() is called, or the
+ *  numerator or denominator has grown by more than MaxBits bits since the value was last reduced.
+ *  For built-in types the growth is counted from zero, so that the limit also keeps the values from overflowing.
+ *  MaxBits = 0 picks half the bits of a built-in type (so that one operation on values under the limit cannot
+ *  overflow) and 4096 bits for other types.
+ *  The const observers (comparisons, numerator(), printing, ...) reduce the value they observe in place, so an
+ *  unreduced value must not be read from several threads at once: canonicalize() it before sharing it.
+ */
+template<std::size_t MaxBits = 0>
+struct LazyReduce {
+	static const bool lazy = true;
+	static const std::size_t max_bits = MaxBits;
+};
+
+namespace fraction_detail {
+
+/** Number of bits in |a| for the built-in integer types (bit_length(Integer) is declared in Integer.h)
+ *  @param a
+ *  @return the number of bits in |a| (0 for zero)
+ */
+template<typename T>
+std::size_t bit_length(T a) {
+	unsigned long long m = gcd_detail::magnitude(a);
+	return (m == 0) ? 0 : std::numeric_limits<unsigned long long>::digits - __builtin_clzll(m);
+}
+
+/** Compares a/b with c/d for the built-in integer types, cross-multiplying in 128 bits (which cannot overflow)
+ *  @param a
+ *  @param b (positive)
+ *  @param c
+ *  @param d (positive)
+ *  @return -1, 0 or 1 as a/b <, ==, > c/d
+ */
+template<typename T>
+int compare_quotients(T a, T b, T c, T d, std::true_type /* is_integral */) {
+	__extension__ typedef typename std::conditional<std::is_signed<T>::value, __int128, unsigned __int128>::type wide_t;
+	wide_t x = wide_t(a) * d;
+	wide_t y = wide_t(c) * b;
+	return (x > y) - (x < y);
+}
+
+/** Compares a/b with c/d for other types, by cross-multiplying (Integer has its own version, in Integer.h)
+ */
+template<typename T>
+int compare_quotients(const T& a, const T& b, const T& c, const T& d, std::false_type /* is_integral */) {
+	T x = a * d;
+	T y = c * b;
+	return (y < x) - (x < y);
+}
+
+/** Compares a/b with c/d (b and d positive)
+ *  @return -1, 0 or 1 as a/b <, ==, > c/d
+ */
+template<typename T>
+int compare_quotients(const T& a, const T& b, const T& c, const T& d) {
+	return compare_quotients(a, b, c, d, std::is_integral<T>());
+}
+
+/** Nearest double to numerator/denominator for the built-in integer types
+ *  @param numerator
+ *  @param denominator (positive)
+ *  @return the correctly rounded quotient
+ *
+ *  Both fit in 53 bits: IEEE division of the exact doubles is already correctly rounded. Otherwise the 55 or 56
+ *  leading bits of the quotient and whether any bits remain come from one 128-bit division.
+ */
+template<typename T>
+double to_double(T numerator, T denominator) {
+	__extension__ typedef unsigned __int128 wide_t;
+	unsigned long long p = gcd_detail::magnitude(numerator);
+	unsigned long long q = gcd_detail::magnitude(denominator);
+	bool negative = (numerator < 0);
+	if (q == 0) {
+		double infinity = std::numeric_limits<double>::infinity();
+		return (p == 0) ? std::numeric_limits<double>::quiet_NaN() : (negative ? -infinity : infinity);
+	}
+	if (p < (1ull << 53) && q < (1ull << 53)) {
+		double result = double(p) / double(q);
+		return negative ? -result : result;
+	}
+	long shift = 55 - long(bit_length(p)) + long(bit_length(q)); // p * 2^shift / q has 55 or 56 bits
+	wide_t quotient;
+	bool sticky;
+	if (shift >= 0) {
+		wide_t n = wide_t(p) << shift;
+		quotient = n / q;
+		sticky = (n % q != 0);
+	}
+	else {
+		wide_t d = wide_t(q) << -shift;
+		quotient = p / d;
+		sticky = (p % d != 0);
+	}
+	return words::round_quotient(std::uint64_t(quotient), sticky, shift, negative);
+}
+
+} // namespace fraction_detail
 
-template<typename F>
+template<typename F, typename R = EagerReduce>
 class Fraction {
 public:
 
@@ -22,6 +150,7 @@ public:
 	 *  @return out so that << can be called consecutively
 	 */
     friend std::ostream& operator<<(std::ostream& out, const Fraction& f) {
+		f.normalize();
 		if(f.bottom == 1) {
 			out << f.top;
 		}
@@ -38,7 +167,7 @@ public:
 	 * 
 	 *  Note: this implementation assumes that top and bottom have the same type as the templated fraction class.
 	 */
-	friend std::istream& operator>>(std::istream& in, Fraction<F>& f) {
+	friend std::istream& operator>>(std::istream& in, Fraction<F, R>& f) {
 		F numerator;
 		F denominator;
 		in >> numerator;
@@ -51,19 +180,26 @@ public:
 	 *  @param lhs
 	 *  @param rhs
 	 *  @return true if lhs < rhs
-	 *  Assumes fractions are in reduced form
+	 *  (Denominators are always positive, so cross-multiplying keeps the order. Built-in types cross-multiply in 128
+	 *  bits; Integers are compared by sign, size and a double estimate first, and only multiplied when those are
+	 *  too close to tell)
 	 */
-	friend bool operator<(const Fraction<F>& lhs, const Fraction<F>& rhs) {
-		return (lhs.top * rhs.bottom) < (lhs.bottom * rhs.top);
+	friend bool operator<(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
+		lhs.normalize();
+		rhs.normalize();
+		using fraction_detail::compare_quotients; // compare_quotients(Integer, ...) via argument-dependent lookup
+		return compare_quotients(lhs.top, lhs.bottom, rhs.top, rhs.bottom) < 0;
 	}
 
 	/** Equality: true if lhs == rhs
 	 *  @param lhs
 	 *  @param rhs
 	 *  @return true if lhs == rhs
-	 *  Assumes fractions are in reduced form
+	 *  Reduced forms are unique, so comparing fields is enough
 	 */
-	friend bool operator==(const Fraction<F>& lhs, const Fraction<F>& rhs) {
+	friend bool operator==(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
+		lhs.normalize();
+		rhs.normalize();
 		return (lhs.top == rhs.top) && (lhs.bottom==rhs.bottom);
 	}
 
@@ -71,18 +207,42 @@ public:
 	Fraction();		 // Defaults to 0/1
 
 	//TODO: make this more robust for type conflicts (type casting, error messages)
-	template<typename T>
-	Fraction<F>(T numerator); //numerator/1
+	template<typename T, typename = typename std::enable_if<std::is_constructible<F, T>::value &&
+															!std::is_floating_point<T>::value>::type>
+	Fraction(T numerator); //numerator/1 (for anything F can be made from, so other conversions still apply)
+
+	explicit Fraction(double value); // The exact value of a double or float (explicit: 0.1 is not exactly 1/10)
 
 	template<typename T, typename B>
-	Fraction<F>(T numerator, B denominator); // numerator/denominator
+	Fraction(T numerator, B denominator); // numerator/denominator
+
+	template<std::size_t N>
+	Fraction(const expression::Sum<Fraction, N>& value); // The value of a sum of products
+
+	static Fraction from_reduced(F numerator, F denominator); // Trusts that the parts are reduced (no GCD is taken)
 
 	// Basic math
 	Fraction& operator+=(const Fraction& value); // Adds value to lhs and returns lhs
 	Fraction& operator-=(const Fraction& value); // Subtracts value from lhs and returns lhs
 	Fraction& operator*=(const Fraction& value); // Multiplies value to lhs and returns lhs
 	Fraction& operator/=(const Fraction& value); // Divides value from lhs and returns lhs
-	Fraction operator-() const; // returns -a
+	Fraction operator-() const&; // returns -a
+	Fraction operator-() &&;	  // returns -a, reusing the numerator and denominator of a temporary
+
+	template<std::size_t N>
+	Fraction& operator+=(const expression::Sum<Fraction, N>& value); // Adds a sum of products, reducing once
+	template<std::size_t N>
+	Fraction& operator-=(const expression::Sum<Fraction, N>& value); // Subtracts a sum of products, reducing once
+
+	Fraction& canonicalize(); // Reduces now (only needed in lazy mode) and returns lhs
+
+	// Accessors
+	const F& numerator() const;	  // The numerator of the reduced fraction (carries the sign)
+	const F& denominator() const; // The denominator of the reduced fraction (positive)
+
+	// Conversions
+	double to_double() const;							  // The nearest double (ties to even)
+	Fraction limit_denominator(const F& max_denominator) const; // The closest fraction with a bounded denominator
 
 	// Increment and decrement
 	Fraction& operator++();           // Prefix increment
@@ -96,48 +256,171 @@ public:
 
 
 private:
+	template<typename T>
+	friend struct expression::Evaluate; // Fused sums work on top and bottom directly
+
 	void reduce();
+	void add_reduced(const Fraction& value, bool subtract); // Adds (or subtracts) value, keeping the result reduced
+	void normalize() const;	  // Reduces if lazy mode left the value unreduced
+	void mark_unreduced();	  // Lazy mode: records that the value is unreduced, reducing if it has grown too large
+	static std::size_t growth_limit(); // Lazy mode: how many bits top and bottom may grow by before being reduced
 
-	F top;
-	F bottom;
+	// Mutable so that a lazy value can be reduced when it is observed (which does not change the value it represents)
+	mutable F top;
+	mutable F bottom;
+	mutable std::uint32_t unreduced; // 0 if reduced; otherwise 1 + the size (in bits) when it became unreduced
 
 };
 
-#endif
-
 /** Default constructor of Fraction class
  */
-template<typename F>
-inline Fraction<F>::Fraction() : top(0), bottom(1) {}
+template<typename F, typename R>
+inline Fraction<F, R>::Fraction() : top(0), bottom(1), unreduced(0) {}
 
 /** Constructor with one parameter
  *  @param numerator is the numerator of the fraction (denominator defaults to 1)
  *  TODO: make this more robust for type conflicts (type casting, error messages)
  */
-template<typename F>
-template<typename T>
-inline Fraction<F>::Fraction(T numerator) : top(numerator), bottom(1) {}
+template<typename F, typename R>
+template<typename T, typename>
+inline Fraction<F, R>::Fraction(T numerator) : top(numerator), bottom(1), unreduced(0) {}
+
+/** Constructor from a double (or float): the exact value of its bits, with no rounding
+ *  @param value; infinity gives 1/0 or -1/0, and NaN 0/0 (with reduce()'s warning)
+ *  Throws std::overflow_error if F is a built-in type and the numerator or denominator does not fit in it.
+ *
+ *  A finite double is m * 2^e for a 53-bit integer m; cancelling the factors of two that m and 2^e share (one count
+ *  of trailing zeros, no loop) leaves the fraction reduced.
+ */
+template<typename F, typename R>
+Fraction<F, R>::Fraction(double value) : top(0), bottom(1), unreduced(0) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	bool negative = (bits >> 63) != 0;
+	int biased = int((bits >> 52) & 0x7ff);
+	std::uint64_t mantissa = bits & ((std::uint64_t(1) << 52) - 1);
+	if (biased == 0x7ff) { // Infinity or NaN
+		top = (mantissa != 0) ? 0 : (negative ? -1 : 1);
+		bottom = 0;
+		reduce();
+		return;
+	}
+	if (biased == 0) { // Subnormal (or zero): no implicit leading bit
+		biased = 1;
+	}
+	else {
+		mantissa |= std::uint64_t(1) << 52;
+	}
+	if (mantissa == 0) {
+		return;
+	}
+	int exponent = biased - 1075; // value = mantissa * 2^exponent
+	if (exponent < 0) {
+		int shared = std::min(__builtin_ctzll(mantissa), -exponent);
+		mantissa >>= shared;
+		exponent += shared;
+	}
+	if (std::numeric_limits<F>::is_bounded) {
+		int digits = std::numeric_limits<F>::digits;
+		if (int(fraction_detail::bit_length(mantissa)) + std::max(exponent, 0) > digits || -exponent >= digits) {
+			throw std::overflow_error("double does not fit in this Fraction type");
+		}
+	}
+	top += mantissa;
+	if (exponent > 0) {
+		top <<= exponent;
+	}
+	else if (exponent < 0) {
+		bottom <<= -exponent;
+	}
+	if (negative) {
+		top = -top;
+	}
+}
 
 /** Constructor with two parameters
  *  @param numerator is the top of the fraction
  *  @param denominator is the bottom of the fraction
  *  TODO: make this more robust for type conflicts (type casting, error messages)
  */
-template<typename F>
+template<typename F, typename R>
 template<typename T, typename B>
-inline Fraction<F>::Fraction(T numerator, B denominator) : top(numerator), bottom(denominator) {
+inline Fraction<F, R>::Fraction(T numerator, B denominator) : top(numerator), bottom(denominator), unreduced(0) {
 	reduce();
 }
 
+/** Constructor from a sum of products
+ *  @param value an expression such as a*b + c*d
+ */
+template<typename F, typename R>
+template<std::size_t N>
+inline Fraction<F, R>::Fraction(const expression::Sum<Fraction, N>& value) : Fraction(value.eval()) {}
+
+/** Builds a fraction from parts that are already reduced (such as ones read back from a file), without a GCD
+ *  @param numerator
+ *  @param denominator positive, and coprime to numerator (1 if numerator is 0)
+ *  @return numerator/denominator, as it is
+ */
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::from_reduced(F numerator, F denominator) {
+	Fraction x;
+	x.top = std::move(numerator);
+	x.bottom = std::move(denominator);
+	return x;
+}
+
+/** Adds (or subtracts) value to lhs with Henrici's algorithm
+ *  @param value is the value being added to lhs
+ *  @param subtract is true to subtract value instead
+ *
+ *  For a/b + c/d (both reduced) with g = gcd(b, d), the sum is (a*(d/g) + c*(b/g)) / (b*(d/g)), and only a factor
+ *  of g can still cancel. So instead of reducing the double-width result, this takes gcd(b, d) of the inputs and
+ *  then gcd(numerator, g), which is usually small.
+ *  Lazy mode skips the GCDs and leaves a*d + c*b over b*d for later.
+ */
+template<typename F, typename R>
+void Fraction<F, R>::add_reduced(const Fraction& value, bool subtract) {
+	F g = R::lazy ? F(1) : gcd(bottom, value.bottom);
+	if (g == 1) { // Coprime denominators: a*d + c*b over b*d is already reduced
+		F t = value.top * bottom;
+		top *= value.bottom;
+		if (subtract) {
+			top -= t;
+		}
+		else {
+			top += t;
+		}
+		bottom *= value.bottom;
+		if (R::lazy) {
+			mark_unreduced();
+		}
+		return;
+	}
+
+	F d = value.bottom / g;
+	F t = value.top * (bottom / g);
+	top *= d;
+	if (subtract) {
+		top -= t;
+	}
+	else {
+		top += t;
+	}
+	F g2 = gcd(top, g);
+	if (g2 != 1) {
+		top /= g2;
+		bottom /= g2;
+	}
+	bottom *= d;
+}
+
 /** Adds value to lhs
  *  @param value is the value being added to lhs
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator+=(const Fraction& value){
-	(top *= value.bottom) += value.top*bottom;
-	bottom *= value.bottom;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator+=(const Fraction& value){
+	add_reduced(value, false);
 	return *this;
 }
 
@@ -145,56 +428,275 @@ Fraction<F>& Fraction<F>::operator+=(const Fraction& value){
  *  @param value is the value being subtracted from lhs
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator-=(const Fraction& value){
-	(top *= value.bottom) -= value.top*bottom;
-	bottom *= value.bottom;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator-=(const Fraction& value){
+	add_reduced(value, true);
 	return *this;
 }
 
 /** Multiplies value to lhs
  *  @param value is the value being multiplied
  *  @return reference to lhs
+ *
+ *  For a/b * c/d (both reduced), the only common factors are gcd(a, d) and gcd(c, b); cancelling them before
+ *  multiplying leaves a reduced product without a GCD of the full-size result. (Lazy mode skips the GCDs.)
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator*=(const Fraction& value){
-	top *= value.top;
-	bottom *= value.bottom;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator*=(const Fraction& value){
+	F c = value.top;
+	F d = value.bottom;
+	if (!R::lazy) {
+		F g1 = gcd(top, d);
+		F g2 = gcd(c, bottom);
+		if (g1 != 1) {
+			top /= g1;
+			d /= g1;
+		}
+		if (g2 != 1) {
+			c /= g2;
+			bottom /= g2;
+		}
+	}
+	top *= c;
+	bottom *= d;
+	if (R::lazy) {
+		mark_unreduced();
+	}
 	return *this;
 }
 
 /** Divides value from lhs
  *  @param value is the value being divided
  *  @return reference to lhs
+ *
+ *  a/b / c/d is a*d / (b*c); as for multiplication, gcd(a, c) and gcd(d, b) are cancelled before multiplying.
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator/=(const Fraction& value) {
-	top *= value.bottom;
-	bottom *= value.top;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator/=(const Fraction& value) {
+	if (value.top == 0) { // t/0: let reduce() give the warning
+		top *= value.bottom;
+		bottom *= value.top;
+		reduce();
+		return *this;
+	}
+	F c = value.bottom;
+	F d = value.top;
+	if (!R::lazy) {
+		F g1 = gcd(top, d);
+		F g2 = gcd(c, bottom);
+		if (g1 != 1) {
+			top /= g1;
+			d /= g1;
+		}
+		if (g2 != 1) {
+			c /= g2;
+			bottom /= g2;
+		}
+	}
+	top *= c;
+	bottom *= d;
+	if (bottom < 0) { // The sign of c/d moves to the numerator
+		top = -top;
+		bottom = -bottom;
+	}
+	if (R::lazy) {
+		mark_unreduced();
+	}
+	return *this;
+}
+
+/** Adds a sum of products to lhs
+ *  @param value an expression such as a*b or a*b - c*d
+ *  @return reference to lhs
+ */
+template<typename F, typename R>
+template<std::size_t N>
+Fraction<F, R>& Fraction<F, R>::operator+=(const expression::Sum<Fraction, N>& value) {
+	return *this = *this + value;
+}
+
+/** Subtracts a sum of products from lhs
+ *  @param value an expression such as a*b or a*b - c*d
+ *  @return reference to lhs
+ */
+template<typename F, typename R>
+template<std::size_t N>
+Fraction<F, R>& Fraction<F, R>::operator-=(const expression::Sum<Fraction, N>& value) {
+	return *this = *this - value;
+}
+
+/** Reduces the fraction now; in lazy mode this is where the deferred reduction happens
+ *  @return reference to lhs
+ */
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::canonicalize() {
+	normalize();
 	return *this;
 }
 
+/** Returns the numerator, reducing first if lazy arithmetic left the value unreduced
+ *  @return the numerator of the reduced fraction
+ */
+template<typename F, typename R>
+const F& Fraction<F, R>::numerator() const {
+	normalize();
+	return top;
+}
+
+/** Returns the denominator, reducing first if lazy arithmetic left the value unreduced
+ *  @return the denominator of the reduced fraction
+ */
+template<typename F, typename R>
+const F& Fraction<F, R>::denominator() const {
+	normalize();
+	return bottom;
+}
+
+/** Converts to the nearest double (ties to even), as if the quotient were computed exactly and then rounded
+ *  @return the nearest double; infinity if it is too large, 0 if it is too small; 1/0 gives infinity, 0/0 NaN
+ *
+ *  Only the leading 55 or 56 bits of the quotient are computed, for Integer as well (see to_double in Integer.h).
+ */
+template<typename F, typename R>
+double Fraction<F, R>::to_double() const {
+	normalize();
+	using fraction_detail::to_double; // Built-in types; to_double(Integer, Integer) via argument-dependent lookup
+	return to_double(top, bottom);
+}
+
+/** Finds the closest fraction to this one whose denominator is at most max_denominator (from the continued fraction)
+ *  @param max_denominator; throws std::invalid_argument if it is less than 1
+ *  @return the closest such fraction
+ *
+ *  The best approximation is either the last convergent p1/q1 whose denominator is in range, or the semiconvergent
+ *  (p0 + k*p1)/(q0 + k*q1) with the largest k that keeps the denominator in range. The two are 1/(q1*(q0 + k*q1))
+ *  apart, and p1/q1 is d/(q1*q) from the value (d the remainder left by the expansion so far), so p1/q1 is at least
+ *  as close exactly when 2*(q0 + k*q1) <= q/d. Nothing is multiplied past max_denominator or the value itself, so
+ *  built-in types do not overflow.
+ */
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::limit_denominator(const F& max_denominator) const {
+	if (max_denominator < 1) {
+		throw std::invalid_argument("limit_denominator needs a maximum denominator of at least 1");
+	}
+	normalize();
+	if (bottom <= max_denominator) {
+		return *this;
+	}
+	bool negative = (top < 0);
+	F n = negative ? F(-top) : top; // Expands |top|/bottom
+	F d = bottom;
+	F p0 = 0;
+	F q0 = 1;
+	F p1 = 1;
+	F q1 = 0;
+	for (;;) {
+		F a = n / d;
+		if (q1 != 0 && a > (max_denominator - q0) / q1) { // q0 + a*q1 would pass max_denominator
+			break;
+		}
+		F q2 = q0 + a * q1;
+		F p2 = p0 + a * p1;
+		p0 = std::move(p1);
+		q0 = std::move(q1);
+		p1 = std::move(p2);
+		q1 = std::move(q2);
+		F r = n - a * d;
+		n = std::move(d);
+		d = std::move(r);
+	}
+	F k = (max_denominator - q0) / q1;
+	F semi_top = p0 + k * p1;
+	F semi_bottom = q0 + k * q1;
+	bool convergent = (semi_bottom <= (bottom / d) / 2);
+	F& t = convergent ? p1 : semi_top;
+	F& b = convergent ? q1 : semi_bottom;
+	return Fraction(negative ? F(-t) : t, b);
+}
+
+/** Reduces the fraction if lazy arithmetic left it unreduced
+ *  (Only top and bottom change, and the value they represent stays the same, so this can be done on a const object)
+ */
+template<typename F, typename R>
+void Fraction<F, R>::normalize() const {
+	if (unreduced == 0) {
+		return;
+	}
+	unreduced = 0;
+	if (bottom != 0) { // t/0 stays as it is (reduce() has already warned about it)
+		F divisor = gcd(top, bottom);
+		if (divisor != 1) {
+			top /= divisor;
+			bottom /= divisor;
+		}
+	}
+}
+
+/** Records that lazy arithmetic left the fraction unreduced, and reduces it anyway once the numerator or the
+ *  denominator has grown by more than growth_limit() bits (so that unreduced values cannot grow without bound)
+ */
+template<typename F, typename R>
+void Fraction<F, R>::mark_unreduced() {
+	using fraction_detail::bit_length; // Built-in types; bit_length(Integer) is found by argument-dependent lookup
+	std::size_t bits = std::max(bit_length(top), bit_length(bottom));
+	if (unreduced == 0) {
+		unreduced = static_cast<std::uint32_t>(std::numeric_limits<F>::is_bounded ? 1 : bits + 1);
+	}
+	if (bits > (unreduced - 1) + growth_limit()) {
+		normalize();
+	}
+}
+
+/** Returns how many bits top and bottom may grow by before lazy mode reduces anyway
+ *  @return R::max_bits, or (if that is 0) half the bits of a built-in type and 4096 for other types
+ */
+template<typename F, typename R>
+std::size_t Fraction<F, R>::growth_limit() {
+	if (R::max_bits != 0) {
+		return R::max_bits;
+	}
+	return std::numeric_limits<F>::is_bounded ? std::numeric_limits<F>::digits / 2 : 4096;
+}
+
 /** Negates a fraction value
  *  @return the negated value
  */
-template<typename F>
-Fraction<F> Fraction<F>::operator-() const{
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::operator-() const& {
 	Fraction a = *this;
 	a.top = -top;
 	return a;
 }
 
+/** Negates a temporary fraction in place
+ *  @return the negated value
+ */
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::operator-() && {
+	top = -std::move(top);
+	return std::move(*this);
+}
+
 /** Adds a and b; returns the result
     @param a
     @param b
     @return a + b
 */
-template<typename F>
-Fraction<F> operator+(Fraction<F> a, const Fraction<F>& b) {
-	return a += b;
+template<typename F, typename R>
+Fraction<F, R> operator+(Fraction<F, R> a, const Fraction<F, R>& b) {
+	a += b;
+	return a; // Moved out (return a += b would copy)
+}
+
+/** Adds a and a temporary b, reusing b
+    @param a
+    @param b
+    @return a + b
+*/
+template<typename F, typename R>
+Fraction<F, R> operator+(const Fraction<F, R>& a, Fraction<F, R>&& b) {
+	b += a;
+	return std::move(b);
 }
 
 /** Subtracts a and b; returns the result
@@ -202,19 +704,44 @@ Fraction<F> operator+(Fraction<F> a, const Fraction<F>& b) {
     @param bn
     @return a - b
 */
-template<typename F>
-Fraction<F> operator-(Fraction<F> a, const Fraction<F>& b) {
-	return a -= b;
+template<typename F, typename R>
+Fraction<F, R> operator-(Fraction<F, R> a, const Fraction<F, R>& b) {
+	a -= b;
+	return a;
 }
 
-/** Multiplies a and b; returns the result
+/** Subtracts a temporary b from a, reusing b (a - b is -(b - a))
+    @param a
+    @param b
+    @return a - b
+*/
+template<typename F, typename R>
+Fraction<F, R> operator-(const Fraction<F, R>& a, Fraction<F, R>&& b) {
+	b -= a;
+	return -std::move(b);
+}
+
+/** Multiplies a and b; returns the result (for built-in types, which could overflow in a fused sum)
     @param a
     @param b
     @return a * b
 */
-template<typename F>
-Fraction<F> operator*(Fraction<F> a, const Fraction<F>& b) {
-	return a *= b;
+template<typename F, typename R>
+typename std::enable_if<std::numeric_limits<F>::is_bounded, Fraction<F, R>>::type
+operator*(Fraction<F, R> a, const Fraction<F, R>& b) {
+	a *= b;
+	return a;
+}
+
+/** Multiplies a and b; the product is computed when it is assigned, so that sums of products can be fused
+    @param a
+    @param b
+    @return an expression for a * b (see Expression.h)
+*/
+template<typename F, typename R>
+typename std::enable_if<!std::numeric_limits<F>::is_bounded, expression::Product<Fraction<F, R>>>::type
+operator*(const Fraction<F, R>& a, const Fraction<F, R>& b) {
+	return expression::product(a, b);
 }
 
 /** Divides a and b; returns the result
@@ -222,18 +749,18 @@ Fraction<F> operator*(Fraction<F> a, const Fraction<F>& b) {
  *  @param b
  *  @return a / b
  */
-template<typename F>
-Fraction<F> operator/(Fraction<F> a, const Fraction<F>& b) {
-	return a /= b;
+template<typename F, typename R>
+Fraction<F, R> operator/(Fraction<F, R> a, const Fraction<F, R>& b) {
+	a /= b;
+	return a;
 }
 
 /** Prefix increment (adds 1)
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator++() {
-	top += bottom;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator++() {
+	top += bottom; // gcd(a + b, b) == gcd(a, b), so the result is still reduced
 	return *this;
 }
 
@@ -241,8 +768,8 @@ Fraction<F>& Fraction<F>::operator++() {
  *  @param unused required for postfix version
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F> Fraction<F>::operator++(int unused) {
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::operator++(int unused) {
 	Fraction clone(*this);
 	++(*this);
 	return clone;
@@ -251,10 +778,9 @@ Fraction<F> Fraction<F>::operator++(int unused) {
 /** Prefix decrement (subtracts 1)
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F>& Fraction<F>::operator--() {
-	top -= bottom;
-	reduce();
+template<typename F, typename R>
+Fraction<F, R>& Fraction<F, R>::operator--() {
+	top -= bottom; // gcd(a - b, b) == gcd(a, b), so the result is still reduced
 	return *this;
 }
 
@@ -262,8 +788,8 @@ Fraction<F>& Fraction<F>::operator--() {
  *  @param unused required for postfix version
  *  @return reference to lhs
  */
-template<typename F>
-Fraction<F> Fraction<F>::operator--(int unused) {
+template<typename F, typename R>
+Fraction<F, R> Fraction<F, R>::operator--(int unused) {
 	Fraction clone(*this);
 	--(*this);
 	return clone;
@@ -274,8 +800,8 @@ Fraction<F> Fraction<F>::operator--(int unused) {
     @param rhs
     @return true if lhs != rhs
 */
-template<typename F>
-bool operator!=(const Fraction<F>& lhs, const Fraction<F>& rhs) {
+template<typename F, typename R>
+bool operator!=(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
 	return !(lhs == rhs);
 }
 
@@ -284,8 +810,8 @@ bool operator!=(const Fraction<F>& lhs, const Fraction<F>& rhs) {
     @param rhs
     @return true if lhs > rhs
 */
-template<typename F>
-bool operator>(const Fraction<F>& lhs, const Fraction<F>& rhs) {
+template<typename F, typename R>
+bool operator>(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
 	return rhs < lhs;
 }
 
@@ -294,8 +820,8 @@ bool operator>(const Fraction<F>& lhs, const Fraction<F>& rhs) {
     @param rhs
     @return true if lhs <= rhs
 */
-template<typename F>
-bool operator<=(const Fraction<F>& lhs, const Fraction<F>& rhs) {
+template<typename F, typename R>
+bool operator<=(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
 	return !(lhs > rhs);
 }
 
@@ -304,35 +830,70 @@ bool operator<=(const Fraction<F>& lhs, const Fraction<F>& rhs) {
     @param rhs
     @return true if lhs >= rhs
 */
-template<typename F>
-bool operator>=(const Fraction<F>& lhs, const Fraction<F>& rhs) {
+template<typename F, typename R>
+bool operator>=(const Fraction<F, R>& lhs, const Fraction<F, R>& rhs) {
 	return !(lhs < rhs);
 }
 
-/** Greatest Common Divisor
- *  @param a first value
- *  @param b second value
- *  @return the greatest common divisor between a and b
- *  This function utilizes the Euclidean algorithm for finding the gcd.
+namespace expression {
+
+/** Computes sums of products of Fractions over a common denominator, reducing once at the end
+ *  (Built-in types are added one operation at a time instead, so that the unreduced sum cannot overflow.)
  */
-template<typename T>
-T gcd(T a, T b) {
-	if(a==b) {
-		return a;
-	}
-	else if(a>b) {
-		return gcd(a-b, b);
-	}
-	else {
-		return gcd(a, b-a);
+template<typename F, typename R>
+struct Evaluate<Fraction<F, R>> {
+	static void sum(Fraction<F, R>& dst, const Term<Fraction<F, R>>* terms, std::size_t n) {
+		if (std::numeric_limits<F>::is_bounded) {
+			accumulate(dst, terms, n);
+			return;
+		}
+		F top = 0;
+		F bottom = 1;
+		for (std::size_t i = 0; i < n; ++i) {
+			const Fraction<F, R>& a = *terms[i].a;
+			F t = a.top;
+			F b = a.bottom;
+			if (terms[i].b) {
+				t *= terms[i].b->top;
+				b *= terms[i].b->bottom;
+			}
+			if (terms[i].negative) {
+				t = -t;
+			}
+			if (b == bottom) { // Same denominator (as for whole numbers): just add the numerators
+				top += t;
+			}
+			else if (bottom == 1) {
+				top *= b;
+				top += t;
+				bottom = b;
+			}
+			else { // top/bottom + t/b = (top*b + t*bottom) / (bottom*b)
+				top *= b;
+				top += t * bottom;
+				bottom *= b;
+			}
+		}
+		dst.top = top;
+		dst.bottom = bottom;
+		dst.unreduced = 0;
+		if (R::lazy) {
+			dst.mark_unreduced();
+		}
+		else {
+			dst.reduce();
+		}
 	}
-}
+};
+
+} // namespace expression
 
 /** Reduces the fraction
  *  Gives warnings for t/0 and 0/0
  */
-template<typename F>
-void Fraction<F>::reduce() { // 0/5 -> 0/1
+template<typename F, typename R>
+void Fraction<F, R>::reduce() { // 0/5 -> 0/1
+	unreduced = 0;
 	if(top == 0 && bottom != 0) {
 		bottom = 1;
 	}
@@ -343,7 +904,8 @@ void Fraction<F>::reduce() { // 0/5 -> 0/1
 		std::cout << "Warning: " << *this << std::endl;
 	}
 	else { // 5/5 -> 1/1
-		F divisor = gcd(std::abs(top), std::abs(bottom));
+		using std::abs; // abs(int) etc. from the standard library, abs(Integer) found by argument-dependent lookup
+		F divisor = gcd(abs(top), abs(bottom)); // Binary GCD for built-in types, Lehmer/half-GCD for Integer (Gcd.h)
 		top /= divisor;
 		bottom /= divisor;
 
@@ -354,4 +916,23 @@ void Fraction<F>::reduce() { // 0/5 -> 0/1
 			bottom = -bottom;
 		}
 	}
-}
\ No newline at end of file
+}
+
+namespace std {
+
+/** @struct hash
+ *  @brief Hashes a Fraction by its reduced numerator and denominator, so that equal values hash equally
+ *  (std::hash<Integer> is declared in Integer.h).
+ */
+template<typename F, typename R>
+struct hash<Fraction<F, R>> {
+	std::size_t operator()(const Fraction<F, R>& x) const {
+		std::hash<F> part;
+		std::uint64_t h = words::hash_mix(part(x.numerator()), words::hash_constants[0]);
+		return std::size_t(words::hash_mix(h ^ part(x.denominator()), words::hash_constants[1]));
+	}
+};
+
+} // namespace std
+
+#endif
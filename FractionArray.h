@@ -0,0 +1,388 @@
+/** @file FractionArray.h
+ *  @brief Stores many small fractions as an array of numerators and an array of denominators, with batch arithmetic
+ *  @author Aviva Prins
+ *  @date 10/18/2026
+ *
+ *  std::vector<Fraction<int>> interleaves the numerators and denominators and reduces each result on its own, one
+ *  binary GCD after another. FractionArray<F> keeps them in separate arrays, so that element-wise operations
+ *  1. compute the cross products of a whole block in one loop over contiguous arrays (which the compiler can
+ *     vectorize), in 64 bits, so that the unreduced results cannot overflow;
+ *  2. reduce the whole block with limbs::gcd_n, which runs binary GCD in 4 or 8 lanes at once (see Kernels.cpp);
+ *  3. divide by the gcds and store the reduced results.
+ *  Results are exact: a reduced result whose numerator or denominator does not fit in F throws std::overflow_error
+ *  (Fraction<F> overflows much sooner, since it multiplies in F).
+ *
+ *  Batch operations (dst may be a or b; a and b must have the same size, or std::invalid_argument is thrown):
+ *  add(dst, a, b); sub(dst, a, b); mul(dst, a, b); div(dst, a, b); compare(result, a, b);
+ *  Single elements read as a Fraction<F> and can be assigned one: Fraction<int> f = x[i]; x[i] = f; x[i] += f;
+ *  A zero divisor leaves 1/0, -1/0 or 0/0 in that element, without Fraction's warning.
+ */
+
+#ifndef FRACTION_ARRAY_H
+#define FRACTION_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Fraction.h"
+#include "Limbs.h"
+
+template<typename F = int>
+class FractionArray {
+	static_assert(std::is_integral<F>::value && std::is_signed<F>::value && sizeof(F) <= 4,
+				  "FractionArray computes in 64 bits, so it holds signed types of up to 32 bits");
+
+public:
+	typedef Fraction<F> value_type;
+
+	/** @class reference
+	 *  @brief One element of a FractionArray: reads as a Fraction<F>, and can be assigned one.
+	 */
+	class reference {
+	public:
+		operator Fraction<F>() const; // The element as a Fraction
+
+		reference& operator=(const Fraction<F>& value);
+		reference& operator=(const reference& other);
+		reference& operator+=(const Fraction<F>& value);
+		reference& operator-=(const Fraction<F>& value);
+		reference& operator*=(const Fraction<F>& value);
+		reference& operator/=(const Fraction<F>& value);
+
+		F numerator() const;   // Carries the sign
+		F denominator() const; // Positive
+
+		friend std::ostream& operator<<(std::ostream& out, const reference& x) { // Prints the element as a Fraction
+			return out << Fraction<F>(x);
+		}
+
+	private:
+		friend class FractionArray;
+		reference(FractionArray& array, std::size_t index) : array(&array), index(index) {}
+
+		FractionArray* array;
+		std::size_t index;
+	};
+
+	// Constructors
+	FractionArray() {}								  // Empty
+	explicit FractionArray(std::size_t n) : top(n, 0), bottom(n, 1) {} // n zeros
+
+	// Size
+	std::size_t size() const { return top.size(); }
+	bool empty() const { return top.empty(); }
+	void resize(std::size_t n);	 // New elements are zero
+	void reserve(std::size_t n); // Makes room for n elements
+	void clear();
+
+	// Elements
+	void push_back(const Fraction<F>& value);
+	void assign(const F* numerators, const F* denominators, std::size_t n); // Copies and reduces n fractions at once
+	reference operator[](std::size_t i) { return reference(*this, i); }
+	Fraction<F> operator[](std::size_t i) const { return Fraction<F>::from_reduced(top[i], bottom[i]); } // No GCD
+	const F* numerators() const { return top.data(); }	   // The reduced numerators
+	const F* denominators() const { return bottom.data(); } // The reduced (positive) denominators
+
+	/** Adds element by element
+	 *  @param dst receives a[i] + b[i] (may be a or b)
+	 *  @param a
+	 *  @param b of the same size as a (throws std::invalid_argument otherwise)
+	 */
+	friend void add(FractionArray& dst, const FractionArray& a, const FractionArray& b) {
+		combine(dst, a, b, [](wide_t p, wide_t q, wide_t r, wide_t s, wide_t& t, wide_t& d) {
+			t = p * s + r * q;
+			d = q * s;
+		});
+	}
+
+	/** Subtracts element by element
+	 *  @param dst receives a[i] - b[i] (may be a or b)
+	 *  @param a
+	 *  @param b of the same size as a (throws std::invalid_argument otherwise)
+	 */
+	friend void sub(FractionArray& dst, const FractionArray& a, const FractionArray& b) {
+		combine(dst, a, b, [](wide_t p, wide_t q, wide_t r, wide_t s, wide_t& t, wide_t& d) {
+			t = p * s - r * q;
+			d = q * s;
+		});
+	}
+
+	/** Multiplies element by element
+	 *  @param dst receives a[i] * b[i] (may be a or b)
+	 *  @param a
+	 *  @param b of the same size as a (throws std::invalid_argument otherwise)
+	 */
+	friend void mul(FractionArray& dst, const FractionArray& a, const FractionArray& b) {
+		combine(dst, a, b, [](wide_t p, wide_t q, wide_t r, wide_t s, wide_t& t, wide_t& d) {
+			t = p * r;
+			d = q * s;
+		});
+	}
+
+	/** Divides element by element
+	 *  @param dst receives a[i] / b[i] (may be a or b)
+	 *  @param a
+	 *  @param b of the same size as a (throws std::invalid_argument otherwise)
+	 */
+	friend void div(FractionArray& dst, const FractionArray& a, const FractionArray& b) {
+		combine(dst, a, b, [](wide_t p, wide_t q, wide_t r, wide_t s, wide_t& t, wide_t& d) {
+			wide_t sign = (r < 0) ? -1 : 1; // The sign of r moves to the numerator
+			t = p * s * sign;
+			d = q * r * sign;
+		});
+	}
+
+	/** Compares element by element (cross-multiplying in 64 bits, so it cannot overflow)
+	 *  @param result receives -1, 0 or 1 as a[i] <, ==, > b[i]
+	 *  @param a
+	 *  @param b of the same size as a (throws std::invalid_argument otherwise)
+	 */
+	friend void compare(std::vector<int>& result, const FractionArray& a, const FractionArray& b) {
+		if (a.size() != b.size()) {
+			throw std::invalid_argument("compare needs two FractionArrays of the same size");
+		}
+		std::size_t n = a.size();
+		result.resize(n);
+		int* out = result.data();
+		const F* p = a.top.data();
+		const F* q = a.bottom.data();
+		const F* r = b.top.data();
+		const F* s = b.bottom.data();
+		for (std::size_t i = 0; i < n; ++i) { // p/q vs r/s: p*s vs r*q
+			wide_t x = wide_t(p[i]) * s[i];
+			wide_t y = wide_t(r[i]) * q[i];
+			out[i] = (x > y) - (x < y);
+		}
+	}
+
+private:
+	typedef std::int64_t wide_t;
+	static const std::size_t block = 256; // Elements per pass (the scratch arrays stay in the L1 cache)
+
+	template<typename Cross>
+	static void combine(FractionArray& dst, const FractionArray& a, const FractionArray& b, Cross cross);
+	static void reduce_block(F* top, F* bottom, wide_t* t, wide_t* d, limbs::limb_t* g, std::size_t n);
+
+	std::vector<F> top;	   // Numerators (carrying the signs)
+	std::vector<F> bottom; // Denominators (positive)
+};
+
+template<typename F>
+const std::size_t FractionArray<F>::block;
+
+/** Changes the number of elements
+ *  @param n the new size; new elements are 0/1
+ */
+template<typename F>
+void FractionArray<F>::resize(std::size_t n) {
+	top.resize(n, 0);
+	bottom.resize(n, 1);
+}
+
+/** Makes room for n elements without changing the size
+ *  @param n
+ */
+template<typename F>
+void FractionArray<F>::reserve(std::size_t n) {
+	top.reserve(n);
+	bottom.reserve(n);
+}
+
+/** Removes all the elements
+ */
+template<typename F>
+void FractionArray<F>::clear() {
+	top.clear();
+	bottom.clear();
+}
+
+/** Appends an element
+ *  @param value (already reduced, as every Fraction is)
+ */
+template<typename F>
+void FractionArray<F>::push_back(const Fraction<F>& value) {
+	top.push_back(value.numerator());
+	bottom.push_back(value.denominator());
+}
+
+/** Replaces the contents with n fractions, reducing them all in one batch
+ *  @param numerators
+ *  @param denominators (of any sign); throws std::overflow_error if a reduced denominator does not fit in F once
+ *  made positive (such as 1/INT32_MIN)
+ *  @param n
+ */
+template<typename F>
+void FractionArray<F>::assign(const F* numerators, const F* denominators, std::size_t n) {
+	resize(n);
+	wide_t t[block];
+	wide_t d[block];
+	limbs::limb_t g[block];
+	for (std::size_t start = 0; start < n; start += block) {
+		std::size_t m = std::min(block, n - start);
+		for (std::size_t i = 0; i < m; ++i) {
+			wide_t sign = (denominators[start + i] < 0) ? -1 : 1;
+			t[i] = wide_t(numerators[start + i]) * sign;
+			d[i] = wide_t(denominators[start + i]) * sign;
+		}
+		reduce_block(top.data() + start, bottom.data() + start, t, d, g, m);
+	}
+}
+
+/** Runs an element-wise operation a block at a time: the cross products of the block, then one batch of GCDs
+ *  @param dst receives the results (may be a or b)
+ *  @param a
+ *  @param b of the same size as a (throws std::invalid_argument otherwise)
+ *  @param cross computes the unreduced numerator t and denominator d (d >= 0) from a[i] = p/q and b[i] = r/s
+ */
+template<typename F>
+template<typename Cross>
+void FractionArray<F>::combine(FractionArray& dst, const FractionArray& a, const FractionArray& b, Cross cross) {
+	if (a.size() != b.size()) {
+		throw std::invalid_argument("element-wise operation on FractionArrays of different sizes");
+	}
+	std::size_t n = a.size();
+	dst.resize(n);
+	wide_t t[block];
+	wide_t d[block];
+	limbs::limb_t g[block];
+	for (std::size_t start = 0; start < n; start += block) {
+		std::size_t m = std::min(block, n - start);
+		const F* p = a.top.data() + start;
+		const F* q = a.bottom.data() + start;
+		const F* r = b.top.data() + start;
+		const F* s = b.bottom.data() + start;
+		for (std::size_t i = 0; i < m; ++i) {
+			cross(p[i], q[i], r[i], s[i], t[i], d[i]);
+		}
+		reduce_block(dst.top.data() + start, dst.bottom.data() + start, t, d, g, m);
+	}
+}
+
+/** Reduces a block of fractions and stores them
+ *  @param top receives the reduced numerators
+ *  @param bottom receives the reduced denominators
+ *  @param t the numerators (|t| < 2^63), divided in place by the gcds
+ *  @param d the denominators (0 <= d < 2^63), divided in place by the gcds
+ *  @param g scratch space for n gcds
+ *  @param n the number of fractions (at most block)
+ *  Throws std::overflow_error, before storing any of the block, if a reduced numerator or denominator does not fit
+ *  in F (the blocks before it have already been stored).
+ */
+template<typename F>
+void FractionArray<F>::reduce_block(F* top, F* bottom, wide_t* t, wide_t* d, limbs::limb_t* g, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) { // |t|, replaced by gcd(|t|, d)
+		g[i] = (t[i] < 0) ? limbs::limb_t(0) - limbs::limb_t(t[i]) : limbs::limb_t(t[i]);
+	}
+	limbs::gcd_n(g, g, reinterpret_cast<const limbs::limb_t*>(d), n);
+	bool fits = true;
+	for (std::size_t i = 0; i < n; ++i) { // Divide in place, checking the whole block before storing any of it
+		wide_t divisor = (g[i] == 0) ? 1 : wide_t(g[i]); // gcd(0, 0) == 0 only for 0/0
+		t[i] /= divisor;
+		d[i] /= divisor;
+		fits &= (t[i] >= std::numeric_limits<F>::min()) & (t[i] <= std::numeric_limits<F>::max()) &
+				(d[i] <= std::numeric_limits<F>::max());
+	}
+	if (!fits) {
+		throw std::overflow_error("reduced fraction does not fit in this FractionArray type");
+	}
+	for (std::size_t i = 0; i < n; ++i) {
+		top[i] = F(t[i]);
+		bottom[i] = F(d[i]);
+	}
+}
+
+/** Reads the element as a Fraction (it is stored reduced, so no GCD is taken, and 1/0 reads without a warning)
+ *  @return the element
+ */
+template<typename F>
+FractionArray<F>::reference::operator Fraction<F>() const {
+	return Fraction<F>::from_reduced(array->top[index], array->bottom[index]);
+}
+
+/** Stores a Fraction in the element
+ *  @param value
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator=(const Fraction<F>& value) {
+	array->top[index] = value.numerator();
+	array->bottom[index] = value.denominator();
+	return *this;
+}
+
+/** Copies another element into this one (x[i] = y[j] copies the value, not the reference)
+ *  @param other
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator=(const reference& other) {
+	array->top[index] = other.numerator();
+	array->bottom[index] = other.denominator();
+	return *this;
+}
+
+/** Adds value to the element
+ *  @param value
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator+=(const Fraction<F>& value) {
+	Fraction<F> x = *this;
+	x += value;
+	return *this = x;
+}
+
+/** Subtracts value from the element
+ *  @param value
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator-=(const Fraction<F>& value) {
+	Fraction<F> x = *this;
+	x -= value;
+	return *this = x;
+}
+
+/** Multiplies the element by value
+ *  @param value
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator*=(const Fraction<F>& value) {
+	Fraction<F> x = *this;
+	x *= value;
+	return *this = x;
+}
+
+/** Divides the element by value
+ *  @param value
+ *  @return reference to the element
+ */
+template<typename F>
+typename FractionArray<F>::reference& FractionArray<F>::reference::operator/=(const Fraction<F>& value) {
+	Fraction<F> x = *this;
+	x /= value;
+	return *this = x;
+}
+
+/** Returns the numerator of the element
+ *  @return the reduced numerator (with the sign of the element)
+ */
+template<typename F>
+F FractionArray<F>::reference::numerator() const {
+	return array->top[index];
+}
+
+/** Returns the denominator of the element
+ *  @return the reduced denominator (positive)
+ */
+template<typename F>
+F FractionArray<F>::reference::denominator() const {
+	return array->bottom[index];
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,459 @@
+/** @file Gcd.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Greatest common divisors of Integers.
+
+Lehmer's algorithm runs Euclid's algorithm on the leading 128 bits of both operands, with 64-bit cofactors, for
+as long as Jebelean's conditions guarantee that the quotients are the same as those of the full operands. One
+multiply-and-subtract pass over the full operands then makes up for dozens of quotient steps (applied with mul_1 and
+submul_1 into reused buffers when only the GCD is wanted). Once the operands fit in one limb, binary GCD finishes the
+job; operands that fit in two limbs from the start go straight to binary GCD on double words, without allocating.
+
+Above thresholds.gcd_half limbs, the half-GCD reduces the operands to half their size with two recursive calls on
+their leading halves (Moller's variant of Schonhage's algorithm), so the GCD costs O(M(n) log n) instead of O(n^2).
+
+All the reductions are products of 2x2 matrices with determinant +1 or -1, which never change the GCD. Any negative
+result is negated (and the operands are swapped if they come out of order), so the answer is right even when an
+approximation gives a quotient that the full operands would not; it would only be slower.
+*/
+
+#include "Gcd.h"
+#include "Integer.h"
+#include "Limbs.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+typedef Integer::limb_t limb_t;
+typedef unsigned __int128 limb2_t;
+
+/** @class Matrix
+	@brief A 2x2 matrix of Integers with determinant +1 or -1.
+
+A reduction maps the operands (a, b) to (r00*a + r01*b, r10*a + r11*b).
+*/
+struct Matrix {
+	Integer r00 = 1, r01 = 0;
+	Integer r10 = 0, r11 = 1;
+};
+
+std::size_t size(const Integer& a) {
+	return a.magnitude().size();
+}
+
+Integer from_limb(limb_t a) {
+	LimbBuffer limb;
+	limb.push_back(a);
+	return Integer::from_magnitude(std::move(limb));
+}
+
+/** Returns the value of at most two limbs as a double word
+*/
+limb2_t to_limb2(const LimbBuffer& a) {
+	limb2_t low = (a.size() > 0) ? a[0] : 0;
+	return (a.size() > 1) ? ((limb2_t)a[1] << 64) | low : low;
+}
+
+/** Returns a double word as an Integer (which keeps it inline, without allocating)
+*/
+Integer from_limb2(limb2_t a) {
+	LimbBuffer limb;
+	limb.push_back((limb_t)a);
+	limb.push_back((limb_t)(a >> 64));
+	return Integer::from_magnitude(std::move(limb));
+}
+
+/** Counts the zero bits below the lowest set bit of a nonzero double word
+*/
+int count_trailing_zeros(limb2_t x) {
+	limb_t low = (limb_t)x;
+	return low ? __builtin_ctzll(low) : 64 + __builtin_ctzll((limb_t)(x >> 64));
+}
+
+/** Binary GCD on double words, finishing on single words once both operands fit in one
+	@return gcd(u, v)
+*/
+limb2_t binary_gcd_2(limb2_t u, limb2_t v) {
+	if (u == 0 || v == 0) {
+		return u | v;
+	}
+	int shift = count_trailing_zeros(u | v);
+	u >>= count_trailing_zeros(u);
+	for (;;) {
+		v >>= count_trailing_zeros(v);
+		if (u > v) {
+			std::swap(u, v);
+		}
+		if ((v >> 64) == 0) {
+			return (limb2_t)gcd_detail::binary_gcd<limb_t>((limb_t)u, (limb_t)v) << shift;
+		}
+		v -= u;
+		if (v == 0) {
+			return u << shift;
+		}
+	}
+}
+
+/** Returns a without its k least significant limbs (a >> 64k for a >= 0)
+*/
+Integer high_part(const Integer& a, std::size_t k) {
+	const LimbBuffer& limb = a.magnitude();
+	LimbBuffer high;
+	if (limb.size() > k) {
+		high.resize(limb.size() - k);
+		std::copy(limb.begin() + k, limb.end(), high.begin());
+	}
+	return Integer::from_magnitude(std::move(high));
+}
+
+/** Restores a >= b >= 0 after a reduction (keeping the matrix in step with the operands)
+*/
+void normalize(Integer& a, Integer& b, Matrix* m) {
+	if (a.is_negative()) {
+		a = -a;
+		if (m) {
+			m->r00 = -m->r00;
+			m->r01 = -m->r01;
+		}
+	}
+	if (b.is_negative()) {
+		b = -b;
+		if (m) {
+			m->r10 = -m->r10;
+			m->r11 = -m->r11;
+		}
+	}
+	if (a < b) {
+		std::swap(a, b);
+		if (m) {
+			std::swap(m->r00, m->r10);
+			std::swap(m->r01, m->r11);
+		}
+	}
+}
+
+/** Applies a reduction to the operands and composes it into m (m = step * m)
+	@param a, b the operands, replaced by the reduced operands
+	@param step the reduction
+	@param m the reduction so far (or nullptr if only the operands are wanted)
+*/
+void apply(Integer& a, Integer& b, const Matrix& step, Matrix* m) {
+	Integer x = step.r00 * a + step.r01 * b;
+	b = step.r10 * a + step.r11 * b;
+	a = std::move(x);
+	if (m) {
+		Integer r00 = step.r00 * m->r00 + step.r01 * m->r10;
+		Integer r01 = step.r00 * m->r01 + step.r01 * m->r11;
+		m->r10 = step.r10 * m->r00 + step.r11 * m->r10;
+		m->r11 = step.r10 * m->r01 + step.r11 * m->r11;
+		m->r00 = std::move(r00);
+		m->r01 = std::move(r01);
+	}
+	normalize(a, b, m);
+}
+
+/** One step of Euclid's algorithm: (a, b) becomes (b, a mod b)
+*/
+void euclid_step(Integer& a, Integer& b, Matrix* m) {
+	Integer q, r;
+	divmod(q, r, a, b);
+	a = std::move(b);
+	b = std::move(r);
+	if (m) {
+		Integer r10 = m->r00 - q * m->r10;
+		Integer r11 = m->r01 - q * m->r11;
+		std::swap(m->r00, m->r10);
+		std::swap(m->r01, m->r11);
+		m->r10 = std::move(r10);
+		m->r11 = std::move(r11);
+	}
+}
+
+/** Returns the limb of a at position i (zero past the end)
+*/
+limb_t limb_at(const LimbBuffer& a, std::size_t i) {
+	return (i < a.size()) ? a[i] : 0;
+}
+
+/** Returns the 128 bits of a that start at bit 64*(top-1) + shift (the leading bits of an operand of top+1 limbs)
+*/
+limb2_t top_bits(const LimbBuffer& a, std::size_t top, int shift) {
+	limb_t high = limb_at(a, top);
+	limb_t middle = limb_at(a, top - 1);
+	limb_t low = (top >= 2) ? limb_at(a, top - 2) : 0;
+	if (shift != 0) {
+		high = (high << shift) | (middle >> (64 - shift));
+		middle = (middle << shift) | (low >> (64 - shift));
+	}
+	return ((limb2_t)high << 64) | middle;
+}
+
+/** Runs Euclid's algorithm on the leading bits x >= y of the operands for as many steps as Jebelean's conditions
+	allow, so that the quotients are also those of the full operands
+	@param u0, v0 receive the cofactors of the first reduced operand, (-1)^k (u0*a - v0*b) after k steps
+	@param u1, v1 receive the cofactors of the second reduced operand, (-1)^(k+1) (u1*a - v1*b)
+	@return the number of steps k (zero if the leading bits do not determine even one quotient)
+*/
+int lehmer(limb2_t x, limb2_t y, limb_t& u0, limb_t& v0, limb_t& u1, limb_t& v1) {
+	const limb2_t limit = ~limb_t(0);
+	limb2_t a0 = 1, b0 = 0, a1 = 0, b1 = 1;
+	int steps = 0;
+	while (y != 0) {
+		limb2_t q = 1;
+		limb2_t r = x - y;
+		if (r >= y) {
+			q = x / y;
+			r = x - q * y;
+		}
+		if (q > limit || (a1 != 0 && q > (limit - a0) / a1) || (b1 != 0 && q > (limit - b0) / b1)) {
+			break; // The next cofactors would not fit in a limb
+		}
+		limb2_t a2 = a0 + q * a1;
+		limb2_t b2 = b0 + q * b1;
+		// Jebelean: r >= |next cofactor| and y - r >= |next cofactor - current cofactor| (the signs alternate)
+		if (r < a2 || r < b2 || y - r < a2 + a1 || y - r < b2 + b1) {
+			break;
+		}
+		x = y;
+		y = r;
+		a0 = a1;
+		a1 = a2;
+		b0 = b1;
+		b1 = b2;
+		++steps;
+	}
+	u0 = (limb_t)a0;
+	v0 = (limb_t)b0;
+	u1 = (limb_t)a1;
+	v1 = (limb_t)b1;
+	return steps;
+}
+
+/** Computes r[0,n) = p*c - q*d
+	@return false if the result is negative or does not fit in n limbs (r is then garbage)
+*/
+bool mul_sub(limb_t* r, const limb_t* p, limb_t c, const limb_t* q, limb_t d, std::size_t n) {
+	limb_t high = limbs::mul_1(r, p, n, c);
+	return high == limbs::submul_1(r, q, n, d);
+}
+
+/** lehmer_reduce when no matrix is wanted (plain gcd): each step is applied to the limbs with mul_1 and submul_1,
+	into two buffers that are allocated once and then swapped with the operands, instead of through Integer products
+*/
+void lehmer_reduce_limbs(Integer& a, Integer& b, std::size_t s) {
+	LimbBuffer x = a.magnitude();
+	LimbBuffer y = b.magnitude();
+	LimbBuffer next_x;
+	LimbBuffer next_y;
+	next_x.reserve(x.size());
+	next_y.reserve(x.size());
+	while (y.size() > s) {
+		std::size_t n = x.size();
+		int shift = __builtin_clzll(x[n - 1]);
+		limb_t u0, v0, u1, v1;
+		int steps = lehmer(top_bits(x, n - 1, shift), top_bits(y, n - 1, shift), u0, v0, u1, v1);
+		y.resize(n); // Zero-padded to the length of x
+		next_x.resize(n);
+		next_y.resize(n);
+		bool done = false;
+		if (steps % 2 == 0 && steps != 0) { // (u0*x - v0*y, v1*y - u1*x)
+			done = mul_sub(next_x.data(), x.data(), u0, y.data(), v0, n) &&
+				mul_sub(next_y.data(), y.data(), v1, x.data(), u1, n);
+		}
+		else if (steps % 2 == 1) { // (v0*y - u0*x, u1*x - v1*y)
+			done = mul_sub(next_x.data(), y.data(), v0, x.data(), u0, n) &&
+				mul_sub(next_y.data(), x.data(), u1, y.data(), v1, n);
+		}
+		if (!done) { // The leading bits do not determine a quotient: one Euclid step on the full operands
+			y.resize(limbs::normalized_size(y.data(), n));
+			a = Integer::from_magnitude(x);
+			b = Integer::from_magnitude(y);
+			euclid_step(a, b, nullptr);
+			x = a.magnitude();
+			y = b.magnitude();
+			continue;
+		}
+		next_x.resize(limbs::normalized_size(next_x.data(), n));
+		next_y.resize(limbs::normalized_size(next_y.data(), n));
+		x.swap(next_x);
+		y.swap(next_y);
+		if (x.size() < y.size() || (x.size() == y.size() && limbs::cmp_n(x.data(), y.data(), x.size()) < 0)) {
+			x.swap(y);
+		}
+	}
+	a = Integer::from_magnitude(std::move(x));
+	b = Integer::from_magnitude(std::move(y));
+}
+
+/** Reduces a >= b >= 0 with Lehmer steps (or Euclid steps when the leading bits are not enough) until b has at most
+	s limbs (s >= 1)
+*/
+void lehmer_reduce(Integer& a, Integer& b, Matrix* m, std::size_t s) {
+	if (!m) {
+		lehmer_reduce_limbs(a, b, s);
+		return;
+	}
+	while (size(b) > s) {
+		const LimbBuffer& x = a.magnitude();
+		const LimbBuffer& y = b.magnitude();
+		std::size_t top = x.size() - 1;
+		int shift = __builtin_clzll(x[top]);
+		limb_t u0, v0, u1, v1;
+		int steps = lehmer(top_bits(x, top, shift), top_bits(y, top, shift), u0, v0, u1, v1);
+		if (steps == 0) {
+			euclid_step(a, b, m);
+			continue;
+		}
+		Matrix step;
+		step.r00 = from_limb(u0);
+		step.r01 = -from_limb(v0);
+		step.r10 = -from_limb(u1);
+		step.r11 = from_limb(v1);
+		if (steps % 2 == 1) {
+			step.r00 = -step.r00;
+			step.r01 = -step.r01;
+			step.r10 = -step.r10;
+			step.r11 = -step.r11;
+		}
+		apply(a, b, step, m);
+	}
+}
+
+/** Half-GCD: reduces a >= b >= 0 of n limbs until b has at most n/2 + 1 limbs, using recursive calls on the leading
+	halves of the operands for the bulk of the work
+	@param a, b the operands, replaced by the reduced operands
+	@param m the reduction is composed into m (or nullptr if only the operands are wanted)
+*/
+void half_gcd(Integer& a, Integer& b, Matrix* m) {
+	std::size_t n = size(a);
+	std::size_t s = n / 2 + 1;
+	if (size(b) <= s) {
+		return;
+	}
+	if (n < limbs::thresholds.gcd_half) {
+		lehmer_reduce(a, b, m, s);
+		return;
+	}
+
+	// Reducing the leading n - k limbs to half their size reduces the full operands to about 3n/4 limbs
+	std::size_t k = n / 2;
+	Integer a_high = high_part(a, k);
+	Integer b_high = high_part(b, k);
+	Matrix first;
+	half_gcd(a_high, b_high, &first);
+	apply(a, b, first, m);
+	if (size(b) <= s) {
+		return;
+	}
+
+	euclid_step(a, b, m);
+	if (size(b) <= s) {
+		return;
+	}
+
+	// The second call takes the rest of the way down to s limbs
+	std::size_t n2 = size(a);
+	if (2 * s > n2 && 2 * s - n2 < n2) {
+		k = 2 * s - n2;
+		a_high = high_part(a, k);
+		b_high = high_part(b, k);
+		Matrix second;
+		half_gcd(a_high, b_high, &second);
+		apply(a, b, second, m);
+	}
+	lehmer_reduce(a, b, m, s); // Usually nothing (or a step or two) is left to do
+}
+
+/** Reduces a >= b >= 0 until b fits in one limb
+*/
+void reduce(Integer& a, Integer& b, Matrix* m) {
+	while (size(b) > 1) {
+		if (size(b) >= limbs::thresholds.gcd_half) {
+			std::size_t before = size(a);
+			half_gcd(a, b, m);
+			if (size(a) == before && size(b) > 1) {
+				euclid_step(a, b, m); // Makes sure of progress
+			}
+		}
+		else {
+			lehmer_reduce(a, b, m, 1);
+		}
+	}
+}
+
+} // namespace
+
+/** Greatest Common Divisor of two Integers
+	@param a first value
+	@param b second value
+	@return the greatest common divisor of a and b (never negative; gcd(0, 0) == 0)
+*/
+Integer gcd(const Integer& a, const Integer& b) {
+	if (size(a) <= 2 && size(b) <= 2) { // Both fit in a double word: no copies and no Integer temporaries
+		return from_limb2(binary_gcd_2(to_limb2(a.magnitude()), to_limb2(b.magnitude())));
+	}
+	Integer x = a.abs();
+	Integer y = b.abs();
+	if (x < y) {
+		std::swap(x, y);
+	}
+	reduce(x, y, nullptr);
+	if (y == 0) {
+		return x;
+	}
+
+	// y fits in one limb: one division brings x down to one limb too, and binary GCD finishes
+	limb_t remainder;
+	if (size(x) == 1) {
+		remainder = x.magnitude()[0] % y.magnitude()[0];
+	}
+	else {
+		LimbBuffer quotient;
+		quotient.resize(size(x));
+		remainder = limbs::divrem_1(quotient.data(), x.magnitude().data(), size(x), y.magnitude()[0]);
+	}
+	return from_limb(gcd_detail::binary_gcd<limb_t>(y.magnitude()[0], remainder));
+}
+
+/** Extended Greatest Common Divisor of two Integers: finds g = gcd(a, b) and s, t with g = s*a + t*b
+	@param g receives gcd(a, b) (never negative)
+	@param s receives the cofactor of a; |s| < |b|/g when b != 0
+	@param t receives the cofactor of b
+	@param a first value
+	@param b second value
+	g, s and t may be the same objects as a and b (but not each other).
+*/
+void xgcd(Integer& g, Integer& s, Integer& t, const Integer& a, const Integer& b) {
+	Integer x = a.abs();
+	Integer y = b.abs();
+	bool swapped = (x < y);
+	if (swapped) {
+		std::swap(x, y);
+	}
+	Matrix m; // (x, y) = m * (|a|, |b|) (or (|b|, |a|) if swapped)
+	reduce(x, y, &m);
+	while (y != 0) {
+		euclid_step(x, y, &m);
+	}
+
+	Integer s_out = swapped ? m.r01 : m.r00;
+	Integer t_out = swapped ? m.r00 : m.r01;
+	if (a.is_negative()) {
+		s_out = -s_out;
+	}
+	if (b.is_negative()) {
+		t_out = -t_out;
+	}
+	if (b != 0 && x != 0) { // Bring s into range; t follows from g = s*a + t*b
+		Integer period = b.abs() / x;
+		if (s_out.abs() >= period) {
+			s_out %= period;
+			t_out = (x - s_out * a) / b;
+		}
+	}
+	g = std::move(x);
+	s = std::move(s_out);
+	t = std::move(t_out);
+}
@@ -0,0 +1,136 @@
+/** @file Gcd.h
+	@brief Contains greatest common divisor routines for the built-in integer types and for Integer
+	@author Aviva Prins
+	@date 10/18/2026
+
+	gcd(a, b) picks its algorithm from the type of its arguments when the program is compiled:
+	1. built-in integer types use binary GCD, which only shifts and subtracts (using a count-trailing-zeros instruction
+	   to remove all the factors of two at once), so it never divides and never recurses;
+	2. Integer has its own overloads (declared in Integer.h, defined in Gcd.cpp), which use Lehmer's algorithm and,
+	   for very large operands, a subquadratic half-GCD;
+	3. any other type falls back to Euclid's algorithm with %.
+
+	xgcd(g, s, t, a, b) also finds Bezout cofactors: g = gcd(a, b) = s*a + t*b.
+	The gcd is never negative, and gcd(0, 0) == 0.
+*/
+
+#ifndef GCD_H
+#define GCD_H
+
+#include <type_traits>
+#include <utility>
+
+namespace gcd_detail {
+
+/** Counts the zero bits below the lowest set bit
+	@param x a nonzero value
+	@return the number of trailing zero bits of x
+*/
+inline int count_trailing_zeros(unsigned long long x) {
+	return __builtin_ctzll(x);
+}
+
+/** Binary GCD (Stein's algorithm) of two unsigned values
+	@param u
+	@param v
+	@return gcd(u, v)
+*/
+template<typename U>
+U binary_gcd(U u, U v) {
+	if (u == 0) {
+		return v;
+	}
+	if (v == 0) {
+		return u;
+	}
+	int shift = count_trailing_zeros(u | v); // The common factors of two
+	u >>= count_trailing_zeros(u);
+	do { // u stays odd; each pass removes the factors of two from v and subtracts the smaller value
+		v >>= count_trailing_zeros(v);
+		if (u > v) {
+			std::swap(u, v);
+		}
+		v -= u;
+	} while (v != 0);
+	return u << shift;
+}
+
+/** Returns |a| as an unsigned value (so that the most negative value does not overflow)
+	@param a
+	@return |a|
+*/
+template<typename T>
+typename std::make_unsigned<T>::type magnitude(T a) {
+	typedef typename std::make_unsigned<T>::type U;
+	return (a < 0) ? U(U(0) - U(a)) : U(a);
+}
+
+/** gcd for built-in integer types
+*/
+template<typename T>
+T gcd(T a, T b, std::true_type /* is_integral */) {
+	typedef typename std::make_unsigned<T>::type U;
+	return T(binary_gcd<U>(magnitude(a), magnitude(b)));
+}
+
+/** gcd for other types: Euclid's algorithm with %
+*/
+template<typename T>
+T gcd(T a, T b, std::false_type /* is_integral */) {
+	while (b != 0) {
+		T r = a % b;
+		a = b;
+		b = r;
+	}
+	return (a < 0) ? -a : a;
+}
+
+} // namespace gcd_detail
+
+/** Greatest Common Divisor
+ *  @param a first value
+ *  @param b second value
+ *  @return the greatest common divisor of a and b (never negative; gcd(0, 0) == 0)
+ *  Built-in integer types use binary GCD; other types use Euclid's algorithm. (Integer has its own overload.)
+ *  For signed types, the result overflows if it is the magnitude of the most negative value.
+ */
+template<typename T>
+T gcd(T a, T b) {
+	return gcd_detail::gcd(a, b, std::is_integral<T>());
+}
+
+/** Extended Greatest Common Divisor: finds g = gcd(a, b) and s, t with g = s*a + t*b
+ *  @param g receives gcd(a, b)
+ *  @param s receives the cofactor of a
+ *  @param t receives the cofactor of b
+ *  @param a first value
+ *  @param b second value
+ *  The cofactors are those of Euclid's algorithm, so |s| <= |b|/g and |t| <= |a|/g (when they are not zero).
+ */
+template<typename T>
+void xgcd(T& g, T& s, T& t, T a, T b) {
+	T s0 = 1, s1 = 0; // a = s0*a_in + t0*b_in and b = s1*a_in + t1*b_in throughout
+	T t0 = 0, t1 = 1;
+	while (b != 0) {
+		T q = a / b;
+		T r = a - q * b;
+		a = b;
+		b = r;
+		T s2 = s0 - q * s1;
+		s0 = s1;
+		s1 = s2;
+		T t2 = t0 - q * t1;
+		t0 = t1;
+		t1 = t2;
+	}
+	if (a < 0) {
+		a = -a;
+		s0 = -s0;
+		t0 = -t0;
+	}
+	g = a;
+	s = s0;
+	t = t0;
+}
+
+#endif //Ends the include guard
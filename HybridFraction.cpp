@@ -0,0 +1,491 @@
+/** @file HybridFraction.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Exact fractions in 64-bit words, promoted to Fraction<Integer> when a result overflows (see HybridFraction.h).
+
+The word arithmetic follows Fraction: Henrici's algorithm for sums (only gcd(b, d) of the denominators, and then a
+gcd with that, instead of reducing the whole result) and cancelling the cross gcds before a product. Each result is
+computed in 128 bits, where the products of two words cannot overflow, and assign() checks whether it fits in words.
+*/
+
+#include "HybridFraction.h"
+#include <iostream>
+#include <limits>
+#include <utility>
+#include "Gcd.h"
+
+namespace {
+
+typedef std::uint64_t word_t;
+__extension__ typedef unsigned __int128 uwide_t;
+
+const word_t word_max = std::numeric_limits<std::int64_t>::max(); // The largest numerator or denominator in words
+
+/** Binary GCD of two words
+	@param a
+	@param b
+	@return gcd(a, b)
+*/
+word_t gcd_words(word_t a, word_t b) {
+	return gcd_detail::binary_gcd<word_t>(a, b);
+}
+
+/** Converts a value of up to 127 bits to an Integer
+	@param a
+	@return a as an Integer
+*/
+template<typename Wide>
+Integer to_integer(Wide a) {
+	uwide_t m = (a < 0) ? uwide_t(0) - uwide_t(a) : uwide_t(a);
+	LimbBuffer limbs;
+	limbs.push_back(word_t(m));
+	limbs.push_back(word_t(m >> 64));
+	return Integer::from_magnitude(std::move(limbs), a < 0);
+}
+
+/** Converts an Integer to a word if it fits
+	@param a
+	@param word receives a, if |a| <= 2^63 - 1
+	@return true if a fits
+*/
+bool to_word(const Integer& a, std::int64_t& word) {
+	const LimbBuffer& m = a.magnitude();
+	if (m.size() > 1 || (m.size() == 1 && m[0] > word_max)) {
+		return false;
+	}
+	word = m.empty() ? 0 : std::int64_t(m[0]);
+	if (a.is_negative()) {
+		word = -word;
+	}
+	return true;
+}
+
+} // namespace
+
+/** Output operator <<
+	@param out
+	@param f is the fraction to be printed
+	@return out so that << can be called consecutively
+*/
+std::ostream& operator<<(std::ostream& out, const HybridFraction& f) {
+	if (f.big) {
+		return out << *f.big;
+	}
+	if (f.bottom == 1) {
+		out << f.top;
+	}
+	else {
+		out << f.top << "/" << f.bottom;
+	}
+	return out;
+}
+
+/** Input operator >>: reads a numerator and a denominator of any size
+	@param in
+	@param f is the fraction to be stored
+	@return in so that >> can be called consecutively
+*/
+std::istream& operator>>(std::istream& in, HybridFraction& f) {
+	Integer numerator;
+	Integer denominator;
+	in >> numerator;
+	in >> denominator;
+	f = HybridFraction(Fraction<Integer>(numerator, denominator));
+	return in;
+}
+
+/** Less than operator: cross-multiplies in 128 bits, which cannot overflow
+	@param lhs
+	@param rhs
+	@return true if lhs < rhs
+*/
+bool operator<(const HybridFraction& lhs, const HybridFraction& rhs) {
+	if (lhs.big && rhs.big) {
+		return *lhs.big < *rhs.big;
+	}
+	if (lhs.big) { // Only the small side is converted (it is already reduced, so there is no GCD)
+		return *lhs.big < rhs.to_fraction();
+	}
+	if (rhs.big) {
+		return lhs.to_fraction() < *rhs.big;
+	}
+	return HybridFraction::wide_t(lhs.top) * rhs.bottom < HybridFraction::wide_t(rhs.top) * lhs.bottom;
+}
+
+/** Equality: true if lhs == rhs
+	@param lhs
+	@param rhs
+	@return true if lhs == rhs
+	Reduced forms are unique, and a big value never fits in words, so a big value never equals a small one
+*/
+bool operator==(const HybridFraction& lhs, const HybridFraction& rhs) {
+	if (lhs.big && rhs.big) {
+		return *lhs.big == *rhs.big;
+	}
+	if (lhs.big || rhs.big) {
+		return false;
+	}
+	return lhs.top == rhs.top && lhs.bottom == rhs.bottom;
+}
+
+/** Default constructor: 0/1
+*/
+HybridFraction::HybridFraction() : top(0), bottom(1) {}
+
+/** Constructor with one parameter
+	@param numerator (the denominator is 1)
+*/
+HybridFraction::HybridFraction(std::int64_t numerator) : top(0), bottom(1) {
+	assign(numerator, 1); // The most negative numerator does not fit (its negation would overflow)
+}
+
+/** Constructor with two parameters
+	@param numerator
+	@param denominator (t/0 is kept as a Fraction<Integer>, which gives a warning)
+*/
+HybridFraction::HybridFraction(std::int64_t numerator, std::int64_t denominator) : top(0), bottom(1) {
+	if (denominator == 0) {
+		big.reset(new Fraction<Integer>(to_integer(wide_t(numerator)), Integer(0)));
+		return;
+	}
+	wide_t g = gcd_words(gcd_detail::magnitude(numerator), gcd_detail::magnitude(denominator));
+	wide_t t = numerator / g;
+	wide_t b = denominator / g;
+	if (b < 0) {
+		t = -t;
+		b = -b;
+	}
+	assign(t, b);
+}
+
+/** Constructor from a Fraction<Integer>
+	@param value (stored in words if it fits)
+*/
+HybridFraction::HybridFraction(const Fraction<Integer>& value) : top(0), bottom(1), big(new Fraction<Integer>(value)) {
+	demote();
+}
+
+/** Copy constructor
+	@param other
+*/
+HybridFraction::HybridFraction(const HybridFraction& other) : top(other.top), bottom(other.bottom) {
+	if (other.big) {
+		big.reset(new Fraction<Integer>(*other.big));
+	}
+}
+
+/** Copy assignment (reuses big, if both values have one)
+	@param other
+	@return reference to lhs
+*/
+HybridFraction& HybridFraction::operator=(const HybridFraction& other) {
+	if (!other.big) {
+		big.reset();
+	}
+	else if (big) {
+		*big = *other.big;
+	}
+	else {
+		big.reset(new Fraction<Integer>(*other.big));
+	}
+	top = other.top;
+	bottom = other.bottom;
+	return *this;
+}
+
+/** Adds (or subtracts) value to lhs
+	@param value is the value being added to lhs
+	@param subtract is true to subtract value instead
+
+	For a/b + c/d with g = gcd(b, d), the sum is (a*(d/g) + c*(b/g)) / (b*(d/g)), and only a factor of g can still
+	cancel. Both products are below 2^126, so their sum cannot overflow 128 bits.
+*/
+void HybridFraction::add(const HybridFraction& value, bool subtract) {
+	if (big || value.big) {
+		Fraction<Integer> v = value.to_fraction();
+		Fraction<Integer>& x = promote();
+		if (subtract) {
+			x -= v;
+		}
+		else {
+			x += v;
+		}
+		demote();
+		return;
+	}
+
+	std::int64_t c = subtract ? -value.top : value.top;
+	std::int64_t g = std::int64_t(gcd_words(word_t(bottom), word_t(value.bottom)));
+	std::int64_t d = value.bottom / g;
+	wide_t t = wide_t(top) * d + wide_t(c) * (bottom / g);
+	wide_t b = wide_t(bottom) * d;
+	if (t == 0) {
+		assign(0, 1);
+		return;
+	}
+	if (g != 1) {
+		uwide_t m = (t < 0) ? uwide_t(0) - uwide_t(t) : uwide_t(t);
+		wide_t g2 = gcd_words(word_t(m % word_t(g)), word_t(g));
+		t /= g2;
+		b /= g2;
+	}
+	assign(t, b);
+}
+
+/** Adds value to lhs
+	@param value is the value being added to lhs
+	@return reference to lhs
+*/
+HybridFraction& HybridFraction::operator+=(const HybridFraction& value) {
+	add(value, false);
+	return *this;
+}
+
+/** Subtracts value from lhs
+	@param value is the value being subtracted from lhs
+	@return reference to lhs
+*/
+HybridFraction& HybridFraction::operator-=(const HybridFraction& value) {
+	add(value, true);
+	return *this;
+}
+
+/** Multiplies value to lhs
+	@param value is the value being multiplied
+	@return reference to lhs
+
+	For a/b * c/d, gcd(a, d) and gcd(c, b) are cancelled before multiplying, which leaves the product reduced.
+*/
+HybridFraction& HybridFraction::operator*=(const HybridFraction& value) {
+	if (big || value.big) {
+		Fraction<Integer> v = value.to_fraction();
+		promote() *= v;
+		demote();
+		return *this;
+	}
+
+	std::int64_t g1 = std::int64_t(gcd_words(gcd_detail::magnitude(top), word_t(value.bottom)));
+	std::int64_t g2 = std::int64_t(gcd_words(gcd_detail::magnitude(value.top), word_t(bottom)));
+	wide_t t = wide_t(top / g1) * (value.top / g2);
+	wide_t b = wide_t(bottom / g2) * (value.bottom / g1);
+	assign(t, b);
+	return *this;
+}
+
+/** Divides value from lhs
+	@param value is the value being divided (division by zero gives Fraction's warning)
+	@return reference to lhs
+
+	a/b / c/d is a*d / (b*c), with gcd(a, c) and gcd(d, b) cancelled first; the sign of c moves to the numerator.
+*/
+HybridFraction& HybridFraction::operator/=(const HybridFraction& value) {
+	if (big || value.big || value.top == 0) {
+		Fraction<Integer> v = value.to_fraction();
+		promote() /= v;
+		demote();
+		return *this;
+	}
+
+	std::int64_t c = value.bottom;
+	std::int64_t d = (value.top < 0) ? -value.top : value.top;
+	std::int64_t g1 = std::int64_t(gcd_words(gcd_detail::magnitude(top), word_t(d)));
+	std::int64_t g2 = std::int64_t(gcd_words(word_t(c), word_t(bottom)));
+	wide_t t = wide_t(top / g1) * (c / g2);
+	wide_t b = wide_t(bottom / g2) * (d / g1);
+	assign((value.top < 0) ? -t : t, b);
+	return *this;
+}
+
+/** Negates a fraction value
+	@return the negated value
+*/
+HybridFraction HybridFraction::operator-() const {
+	HybridFraction a(*this);
+	if (a.big) {
+		*a.big = -std::move(*a.big);
+	}
+	else {
+		a.top = -a.top;
+	}
+	return a;
+}
+
+/** Prefix increment (adds 1)
+	@return reference to lhs
+*/
+HybridFraction& HybridFraction::operator++() {
+	if (big) {
+		++(*big);
+		demote();
+	}
+	else {
+		assign(wide_t(top) + bottom, bottom); // gcd(a + b, b) == gcd(a, b), so the result is still reduced
+	}
+	return *this;
+}
+
+/** Postfix increment (adds 1)
+	@param unused required for postfix version
+	@return the value before the increment
+*/
+HybridFraction HybridFraction::operator++(int unused) {
+	HybridFraction clone(*this);
+	++(*this);
+	return clone;
+}
+
+/** Prefix decrement (subtracts 1)
+	@return reference to lhs
+*/
+HybridFraction& HybridFraction::operator--() {
+	if (big) {
+		--(*big);
+		demote();
+	}
+	else {
+		assign(wide_t(top) - bottom, bottom); // gcd(a - b, b) == gcd(a, b), so the result is still reduced
+	}
+	return *this;
+}
+
+/** Postfix decrement (subtracts 1)
+	@param unused required for postfix version
+	@return the value before the decrement
+*/
+HybridFraction HybridFraction::operator--(int unused) {
+	HybridFraction clone(*this);
+	--(*this);
+	return clone;
+}
+
+/** Returns true if the value is stored in words (so that arithmetic on it does not allocate)
+	@return true if the value fits in 64-bit words
+*/
+bool HybridFraction::is_small() const {
+	return !big;
+}
+
+/** Returns the value as a Fraction<Integer>
+	@return the same value
+*/
+Fraction<Integer> HybridFraction::to_fraction() const {
+	if (big) {
+		return *big;
+	}
+	return Fraction<Integer>::from_reduced(to_integer(wide_t(top)), to_integer(wide_t(bottom))); // Already reduced
+}
+
+/** Stores a reduced result of word arithmetic
+	@param numerator
+	@param denominator (positive)
+	Promotes the result to a Fraction<Integer> if either part does not fit in words
+*/
+void HybridFraction::assign(wide_t numerator, wide_t denominator) {
+	uwide_t m = (numerator < 0) ? uwide_t(0) - uwide_t(numerator) : uwide_t(numerator);
+	if (m <= word_max && uwide_t(denominator) <= word_max) {
+		top = std::int64_t(numerator);
+		bottom = std::int64_t(denominator);
+		big.reset();
+		return;
+	}
+	big.reset(new Fraction<Integer>(Fraction<Integer>::from_reduced(to_integer(numerator), to_integer(denominator))));
+}
+
+/** Moves the value to big, so that it can be worked on as a Fraction<Integer>
+	@return reference to big
+*/
+Fraction<Integer>& HybridFraction::promote() {
+	if (!big) {
+		big.reset(new Fraction<Integer>(to_fraction()));
+	}
+	return *big;
+}
+
+/** Moves the value back to words if its reduced numerator and denominator fit
+*/
+void HybridFraction::demote() {
+	std::int64_t t;
+	std::int64_t b;
+	if (to_word(big->numerator(), t) && to_word(big->denominator(), b) && b > 0) {
+		top = t;
+		bottom = b;
+		big.reset();
+	}
+}
+
+/** Adds a and b; returns the result
+	@param a
+	@param b
+	@return a + b
+*/
+HybridFraction operator+(HybridFraction a, const HybridFraction& b) {
+	a += b;
+	return a;
+}
+
+/** Subtracts a and b; returns the result
+	@param a
+	@param b
+	@return a - b
+*/
+HybridFraction operator-(HybridFraction a, const HybridFraction& b) {
+	a -= b;
+	return a;
+}
+
+/** Multiplies a and b; returns the result
+	@param a
+	@param b
+	@return a * b
+*/
+HybridFraction operator*(HybridFraction a, const HybridFraction& b) {
+	a *= b;
+	return a;
+}
+
+/** Divides a and b; returns the result
+	@param a
+	@param b
+	@return a / b
+*/
+HybridFraction operator/(HybridFraction a, const HybridFraction& b) {
+	a /= b;
+	return a;
+}
+
+/** Returns true if lhs != rhs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs != rhs
+*/
+bool operator!=(const HybridFraction& lhs, const HybridFraction& rhs) {
+	return !(lhs == rhs);
+}
+
+/** Returns true if lhs > rhs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs > rhs
+*/
+bool operator>(const HybridFraction& lhs, const HybridFraction& rhs) {
+	return rhs < lhs;
+}
+
+/** Returns true if lhs <= rhs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs <= rhs
+*/
+bool operator<=(const HybridFraction& lhs, const HybridFraction& rhs) {
+	return !(rhs < lhs);
+}
+
+/** Returns true if lhs >= rhs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs >= rhs
+*/
+bool operator>=(const HybridFraction& lhs, const HybridFraction& rhs) {
+	return !(lhs < rhs);
+}
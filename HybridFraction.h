@@ -0,0 +1,96 @@
+/** @file HybridFraction.h
+	@brief Contains an exact fraction that works on machine words while it can, and on Integers when it must
+	@author Aviva Prins
+	@date 10/18/2026
+
+	Fraction<long long> is fast, but a*d + c*b (and the cross products of <) silently overflow once the denominators
+	pass about 2^31. Fraction<Integer> never overflows, but pays for it on every operation.
+	HybridFraction stores a reduced numerator and denominator in 64-bit words, and computes each result in 128-bit
+	arithmetic (which cannot overflow for 64-bit operands). A result that does not fit in 64 bits again is promoted
+	to a Fraction<Integer>; a result of Fraction<Integer> arithmetic that fits in 64 bits is demoted back to words.
+	So the value is always exact, and small values never allocate.
+
+	HybridFractions can be:
+	1. added, subtracted, multiplied or divided:	a + b; a - b; a * b; a / b; a += b; (etc.)
+	2. incremented and negated:						++a; a++; --a; a--; -a;
+	3. compared:									a < b; a <= b; a == b; a != b; a >= b; a > b;
+	4. printed and read:							std::cout << a; std::cin >> a;
+	5. converted to a Fraction<Integer>:			a.to_fraction(); (and back: HybridFraction(f))
+*/
+
+#ifndef HYBRID_FRACTION_H
+#define HYBRID_FRACTION_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include "Fraction.h"
+#include "Integer.h"
+
+/** @class HybridFraction
+	@brief A reduced fraction of 64-bit words that promotes itself to Fraction<Integer> when a result overflows.
+
+The numerator carries the sign and the denominator is positive. While big is null the value is top/bottom, with
+|top| and bottom at most 2^63 - 1 (so that negating never overflows); otherwise the value is *big, which never fits
+in words (every operation that leaves a big result checks whether it can be demoted).
+
+*/
+class HybridFraction {
+public:
+	friend std::ostream& operator<<(std::ostream& out, const HybridFraction& f);
+	friend std::istream& operator>>(std::istream& in, HybridFraction& f);
+	friend bool operator<(const HybridFraction& lhs, const HybridFraction& rhs);
+	friend bool operator==(const HybridFraction& lhs, const HybridFraction& rhs);
+
+	// Constructors
+	HybridFraction();											  // Defaults to 0/1
+	HybridFraction(std::int64_t numerator);						  // numerator/1
+	HybridFraction(std::int64_t numerator, std::int64_t denominator); // numerator/denominator, reduced
+	HybridFraction(const Fraction<Integer>& value);				  // value (in words if it fits)
+	HybridFraction(const HybridFraction& other);
+	HybridFraction(HybridFraction&& other) noexcept = default;
+
+	HybridFraction& operator=(const HybridFraction& other);
+	HybridFraction& operator=(HybridFraction&& other) noexcept = default;
+
+	// Basic math
+	HybridFraction& operator+=(const HybridFraction& value); // Adds value to lhs and returns lhs
+	HybridFraction& operator-=(const HybridFraction& value); // Subtracts value from lhs and returns lhs
+	HybridFraction& operator*=(const HybridFraction& value); // Multiplies value to lhs and returns lhs
+	HybridFraction& operator/=(const HybridFraction& value); // Divides value from lhs and returns lhs
+	HybridFraction operator-() const;						  // returns -a
+
+	// Increment and decrement
+	HybridFraction& operator++();			// Prefix increment
+	HybridFraction operator++(int unused);	// Postfix increment
+	HybridFraction& operator--();			// Prefix decrement
+	HybridFraction operator--(int unused);	// Postfix decrement
+
+	// Accessors
+	bool is_small() const;					 // True if the value is stored in 64-bit words
+	Fraction<Integer> to_fraction() const; // The value as a Fraction<Integer>
+
+private:
+	__extension__ typedef __int128 wide_t; // Holds any sum or product of two words
+
+	void add(const HybridFraction& value, bool subtract); // Adds (or subtracts) value, keeping the result reduced
+	void assign(wide_t numerator, wide_t denominator); // Stores a reduced result, promoting it if it does not fit
+	Fraction<Integer>& promote(); // Moves the value to big (if it is not there already) and returns big
+	void demote();				  // Moves the value back to words if it fits
+
+	std::int64_t top;	 // Numerator, when big is null
+	std::int64_t bottom; // Denominator (positive), when big is null
+	std::unique_ptr<Fraction<Integer>> big; // The value, when it does not fit in words
+};
+
+HybridFraction operator+(HybridFraction a, const HybridFraction& b); // Adds a + b
+HybridFraction operator-(HybridFraction a, const HybridFraction& b); // Subtracts a - b
+HybridFraction operator*(HybridFraction a, const HybridFraction& b); // Multiplies a * b
+HybridFraction operator/(HybridFraction a, const HybridFraction& b); // Divides a / b
+
+bool operator!=(const HybridFraction& lhs, const HybridFraction& rhs); // True if lhs != rhs
+bool operator>(const HybridFraction& lhs, const HybridFraction& rhs);  // True if lhs > rhs
+bool operator<=(const HybridFraction& lhs, const HybridFraction& rhs); // True if lhs <= rhs
+bool operator>=(const HybridFraction& lhs, const HybridFraction& rhs); // True if lhs >= rhs
+
+#endif //Ends the include guard
@@ -5,6 +5,10 @@
 Positive and negative integer types are stored as objects of a class Integer so that they can be:
 1. added, subtracted, or multiplied:	a + b; a - b; a * b;
 1a.										a += b; a -= b; a *= b;
+1b.										add(c, a, b); sub(c, a, b); addmul(c, a, b); submul(c, a, b);
+1c. divided (truncating toward zero):	a / b; a % b; a /= b; a %= b; divmod(q, r, a, b);
+1d. combined with a built-in integer:	a += 5; a -= 5; a *= 5; a /= 5; a %= 5; divmod(q, a, 5);
+1e. greatest common divisor:			gcd(a, b); xgcd(g, s, t, a, b); (see Gcd.cpp)
 2. incremented:							++a; a++; --a; a--;
 3. shifted:								a << increment; a >> increment;
 3a.										a <<= increment; a >>= increment;
@@ -13,11 +17,30 @@ Positive and negative integer types are stored as objects of a class Integer so
 6. compared bitwise:					a & b; a | b; a ^ b;
 6a.										a &= b; a |= b; a ^= b;
 7. displayed in base 10 or base 2:		a.print_as_int(); a.print_as_bits();
+7a. converted to decimal text:			to_string(a); to_chars(first, last, a); (see Radix.cpp)
+7b. divided into the nearest double:	to_double(a, b);
+8. read in base 10, 16, 8 or 2:			std::cin >> a; from_chars(first, last, a, base);
+9. hashed, a limb at a time:			std::hash<Integer>()(a);
 
 Additional useful functions defined outside of the Integer class:
-Integer operator+(Integer a, const Integer& b); // Adds a + b
-Integer operator-(Integer a, const Integer& b); // Subtracts a - b
-Integer operator*(Integer a, const Integer& b); // Multiplies a * b
+void add(Integer& dst, const Integer& a, const Integer& b); // dst = a + b (dst may be a or b)
+void sub(Integer& dst, const Integer& a, const Integer& b); // dst = a - b (dst may be a or b)
+void divmod(Integer& quotient, Integer& remainder, const Integer& a, const Integer& b); // a = quotient*b + remainder
+std::int64_t divmod(Integer& quotient, const Integer& a, std::int64_t b); // Returns a % b; quotient = a / b
+void addmul(Integer& dst, const Integer& a, const Integer& b); // dst += a * b (without a temporary product)
+void submul(Integer& dst, const Integer& a, const Integer& b); // dst -= a * b (without a temporary product)
+
+Integer operator+(const Integer& a, const Integer& b); // Adds a + b (a temporary a or b is reused)
+Integer operator-(const Integer& a, const Integer& b); // Subtracts a - b (a temporary a or b is reused)
+expression::Product<Integer> operator*(const Integer& a, const Integer& b); // Multiplies a * b (when assigned)
+Integer operator/(Integer a, const Integer& b); // Divides a / b (rounding toward zero)
+Integer operator%(Integer a, const Integer& b); // Remainder a % b (same sign as a)
+Integer abs(const Integer& a);					 // |a|
+Integer abs(Integer&& a);						 // |a|, reusing the limbs of a
+std::size_t bit_length(const Integer& a);		 // Number of bits in |a|
+double to_double(const Integer& numerator, const Integer& denominator); // numerator/denominator, correctly rounded
+int compare_quotients(const Integer& a, const Integer& b, const Integer& c, const Integer& d); // Sign of a/b - c/d
+std::size_t hash_value(const Integer& a); // A hash of the sign and the limbs (equal values hash equally)
 
 bool operator!=(const Integer& lhs, const Integer& rhs); // True if lhs != rhs
 bool operator>(const Integer& lhs, const Integer& rhs);  // True if lhs > rhs
@@ -28,17 +51,23 @@ Integer operator&(Integer a, const Integer& b); // And: returns result of a&b (b
 Integer operator|(Integer a, const Integer& b); // Or:  returns result of a|b (bitwise)
 Integer operator^(Integer a, const Integer& b); // Xor: returns result of a^b (bitwise)
 
-Integer operator<<(Integer& a, const unsigned int& increment); // Returns a shifted up increment number of times
-Integer operator>>(Integer& a, const unsigned int& increment); // Returns a shifted down increment number of times
+Integer operator<<(Integer a, const unsigned int& increment); // Returns a shifted up increment number of times
+Integer operator>>(Integer a, const unsigned int& increment); // Returns a shifted down increment number of times
 
 */
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
 #include <iostream>
 #include <fstream>
+#include <limits>
 #include "Integer.h"
-#include <cmath>
-#include <vector>
+#include "Limbs.h"
+#include "Words.h"
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 /** Output operator <<
 	@param out allows std::cout, etc output types
@@ -54,11 +83,39 @@ std::ostream& operator<<(std::ostream& out, const Integer& i) {
 	@param in allows std::cin, etc input types
 	@param i accepts an Integer type input
 	@return in so that >> can be called consecutively
+
+	Reads an optional sign and any number of digits, in base 16 or 8 if the stream is set to std::hex or std::oct
+	(and base 10 otherwise). If there are no digits, i is left unchanged and the stream's failbit is set.
 */
 std::istream& operator>>(std::istream& in, Integer& i) {
-	int input;
-	in >> input;
-	i = input;
+	std::istream::sentry sentry(in); // Skips leading whitespace
+	if (!sentry) {
+		return in;
+	}
+	std::ios_base::fmtflags basefield = in.flags() & std::ios_base::basefield;
+	int base = (basefield == std::ios_base::hex) ? 16 : (basefield == std::ios_base::oct) ? 8 : 10;
+
+	std::string text;
+	int c = in.peek();
+	if (c == '-' || c == '+') {
+		if (in.get() == '-') {
+			text.push_back('-');
+		}
+		c = in.peek();
+	}
+	while (c != std::char_traits<char>::eof() &&
+		   ((base == 16) ? std::isxdigit(c) != 0 : (c >= '0' && c < '0' + base))) {
+		text.push_back(char(in.get()));
+		c = in.peek();
+	}
+	if (c == std::char_traits<char>::eof()) {
+		in.setstate(std::ios_base::eofbit);
+	}
+
+	FromCharsResult result = from_chars(text.data(), text.data() + text.size(), i, base);
+	if (result.ec != std::errc()) {
+		in.setstate(std::ios_base::failbit);
+	}
 	return in;
 }
 
@@ -66,7 +123,6 @@ std::istream& operator>>(std::istream& in, Integer& i) {
 /** Default constructor of Integer class
 */
 Integer::Integer() {
-	bit = { 0 };
 	sign = 0;
 }
 
@@ -74,204 +130,241 @@ Integer::Integer() {
     @param a is an integer in base 10, which is stored in base 2
 */
 Integer::Integer(int a) {
-	bit = {};    // Intialize bit
 	if (a < 0) { // If a is negative, sign is negative
 		sign = 1;
-		a = -a;  // We change the sign of a for the next step: binary conversion
 	}
 	else {		 // Otherwise, a is positive and the sign is positive
 		sign = 0;
 	}
 
-	// Integer to binary conversion
-	while (a > 1) { // If a > 1, its binary representation will be more than one digit long (digits are determined in reverse order in this method)
-		if (a % 2 == 0) { // Then a is divisible by 2 and inserts 0 at first position, moving the other entries back
-			bit.insert(bit.begin(), 0);
-		}
-		else { // a is not divisible by 2: inserts the remainder (1) at first position, moving the other entries back
-			bit.insert(bit.begin(), 1);
-		}
-		a = a / 2; // integer division
-	}
-
-	// Using the above method, a = 1 and the first digit is one
-	if (a == 1) {
-		bit.insert(bit.begin(), 1);
-	}
-
-	// The only exception to the above is if the initial value is zero
-	else if (a == 0) {
-		bit.insert(bit.begin(), 0);
-	}
-
-	else { // We've covered all the cases, so this should never be printed (for debugging purposes only)
-		std::cout << "Error in constructor class!";
+	// The magnitude is taken in unsigned arithmetic so that INT_MIN does not overflow
+	limb_t magnitude = (a < 0) ? limb_t(0) - limb_t(a) : limb_t(a);
+	if (magnitude != 0) { // Zero is stored without any limbs
+		limb.push_back(magnitude);
 	}
 }
 
-/** Adds value to lhs
-    @param value the value being added, in base 2
+/** Compares the magnitudes of two limb vectors (both without leading zero limbs)
+    @param a
+    @param b
+    @return -1 if |a| < |b|, 0 if |a| == |b|, 1 if |a| > |b|
 */
-Integer& Integer::operator+=(const Integer& value) {
-	// Temp values: a + b = c
-	Integer a;         // Copy of lhs
-	a.bit = bit;
-	a.sign = sign;
-	Integer b = value; // Amount being added to lhs (copy)
-	b.sign = value.sign;
-	Integer c = 0;     // Solution to addition of a and b
-
-	// Determine sign of c
-	// If the magnitude of a is less than the magnitude of b, c is the sign of b
-	if (a.sign == b.sign) {
-		c.sign = a.sign;
-	}
+int Integer::compare_magnitude(const LimbBuffer& a, const LimbBuffer& b) {
 	// Note: Integers are stored without leading zeros, so comparing sizes can determine inequality.
-	else {
-		if (a.bit.size() < b.bit.size()) { // if length lhs < length rhs ==> lhs < rhs
-			c.sign = b.sign;
-		}
-		else if (a.bit.size() > b.bit.size()) { // if length lhs > length rhs ==> lhs > rhs
-			c.sign = a.sign;
-		}
-		else { // length of lhs == length rhs (need to compare bitwise)
-			for (size_t i = a.bit.size() - 1; i <= 0; --i) { // compares each bit, starting with the first
-				if (a.bit[i] < b.bit[i]) { // entry of a < entry of b
-					c.sign = b.sign; // a < b
-					break;
-				}
-				else if (a.bit[i] > b.bit[i]) { // entry of a > entry of b
-					c.sign = a.sign; // a > b
-					break;
-				}
-				else { //lhs == rhs for all entries
-					c.sign = a.sign;
-				}
-			}
-		}
+	if (a.size() != b.size()) {
+		return (a.size() < b.size()) ? -1 : 1;
 	}
+	return limbs::cmp_n(a.data(), b.data(), a.size());
+}
 
+/** Adds a signed value to a, storing the result in dst
+    @param dst receives the result; may be the same object as a or b
+    @param a the first operand
+    @param b the magnitude of the second operand
+    @param b_sign the sign used for b (so that subtraction is addition of -b without making a copy)
 
-	// Size Increase
-	// We need to increase the sizes of a and b so that they are the same size and have two leading zeros (so there's no index issue for carrying)
-	if (a.bit.size() < b.bit.size()) { // Then increase a with leading zeros to 2 + the size of b
-		while (a.bit.size() < b.bit.size() + 2) { // Increases size of a until it is 2 + the size of b
-			a.bit.insert(a.bit.begin(), 0);
+    Works in sign and magnitude: equal signs add the magnitudes, and opposite signs subtract the smaller magnitude
+    from the larger. Either way, it is a single carry (or borrow) pass over the longer operand, written straight into
+    dst. dst only grows when it is shorter than the result.
+*/
+void Integer::add_signed(Integer& dst, const Integer& a, const Integer& b, bool b_sign) {
+	// x is the operand with the larger magnitude (for addition, the longer one), y the other
+	const Integer* x = &a;
+	const Integer* y = &b;
+	bool result_sign = a.sign;
+
+	if (a.sign == b_sign) { // Same signs: add magnitudes
+		if (a.limb.size() < b.limb.size()) {
+			x = &b;
+			y = &a;
 		}
-		b.bit.insert(b.bit.begin(), 0); // Increase b
-		b.bit.insert(b.bit.begin(), 0);
-	}
-	else if (a.bit.size() > b.bit.size()) { // Then increase b with leading zeros to 2 + the size of a
-		while (b.bit.size() < a.bit.size() + 2) { // Increases size of b until it is 2 + the size of a
-			b.bit.insert(b.bit.begin(), 0);
+		std::size_t n = x->limb.size();
+		std::size_t m = y->limb.size();
+		if (dst.limb.capacity() < n) { // dst must grow anyway: leave room for the carry
+			dst.limb.reserve(n + 1);
 		}
-		a.bit.insert(a.bit.begin(), 0); // Increase a
-		a.bit.insert(a.bit.begin(), 0);
-	}
-	else { // Then a is the same size as b. Increase both with two leading zeros.
-		a.bit.insert(a.bit.begin(), 0);
-		a.bit.insert(a.bit.begin(), 0);
-		b.bit.insert(b.bit.begin(), 0);
-		b.bit.insert(b.bit.begin(), 0);
+		dst.limb.resize(n); // Read the operands only after resizing, since dst may be one of them
+		limb_t carry = limbs::add(dst.limb.data(), x->limb.data(), n, y->limb.data(), m);
+		if (carry) { // Only grow when the sum needs another limb
+			dst.limb.push_back(carry);
+		}
+		dst.sign = result_sign;
+		return;
 	}
 
-	// Two's Compelement Conversion
-	// If a or b are negative, we convert them to two's compelement to solve
-	if (a.sign == 1) {
-		//convert to two's complement: flip bits (including signed bit), then add one 
-		a = ~a;
-		++a;
+	// Opposite signs: the result takes the sign of the larger magnitude
+	int cmp = compare_magnitude(a.limb, b.limb);
+	if (cmp == 0) { // a + (-a) = 0
+		dst.limb.clear();
+		dst.sign = 0;
+		return;
 	}
-	if (b.sign == 1) {
-		//convert to two's complement: flip bits (including signed bit), then add one
-		b = ~b;
-		++b;
+	if (cmp < 0) {
+		x = &b;
+		y = &a;
+		result_sign = b_sign;
 	}
+	std::size_t n = x->limb.size();
+	std::size_t m = y->limb.size();
+	dst.limb.resize(n);
+	limbs::sub(dst.limb.data(), x->limb.data(), n, y->limb.data(), m);
+	dst.sign = result_sign;
+	dst.clean_up(); // Remove leading zeros (if there are any)
+}
 
-	// Addition Operation
-	bool carry = 0; // "carried" digit in addition method
-	unsigned int temp = 0; // temporary value used in addition method
+/** Adds value to lhs
+    @param value the value being added
+*/
+Integer& Integer::operator+=(const Integer& value) {
+	add_signed(*this, *this, value, value.sign);
+	return (*this);
+}
 
-	// Adds each digit, starting with the last entry (and carrying, if necessary)
-	for (size_t i = 0, n = a.bit.size(); i < n; ++i) { //credit: Prof. DeSalvo's Syle lecture
-		temp = a.bit[a.bit.size() - 1 - i] + b.bit[b.bit.size() - 1 - i] + carry;
-		c.bit.insert(c.bit.begin(), temp % 2); //note: last digit of c is zero from initialization. Next step is to remove the erroneous zero.
-		carry = temp / 2;
-	}
-	// Remove trailing zero (erroneous)
-	c.bit.pop_back();
+/** Subtracts value from lhs
+    @param value the value being subtracted
+*/
+Integer& Integer::operator-=(const Integer& value) {
+	// lhs - value is lhs + (-value); the sign of value is flipped without copying it
+	add_signed(*this, *this, value, !value.sign);
+	return (*this);
+}
 
-	// If c is negative, convert from two's complement back to sign and magnitude (note that the sign of c has already been determined, so we don't flip the sign)
-	sign = c.sign;
-	if (c.sign == 1) {
-		c = ~c;
-		++c;
+/** Multiplies value to lhs
+    @param value the value being multiplied
+*/
+Integer& Integer::operator*=(const Integer& value) {
+	if (limb.empty() || value.limb.empty()) { // Anything times zero is zero
+		limb.clear();
+		sign = 0;
+		return (*this);
 	}
 
-	// Remove leading zeros (if there are any)
-	c.clean_up();
+	// The product is computed into a separate buffer, since value may be lhs itself
+	LimbBuffer c;
+	c.resize(limb.size() + value.limb.size());
+	if (&value == this || limb == value.limb) { // a * a: squaring is cheaper
+		limbs::sqr(c.data(), limb.data(), limb.size());
+	}
+	else {
+		limbs::mul(c.data(), limb.data(), limb.size(), value.limb.data(), value.limb.size());
+	}
 
-	bit = c.bit; //reassigns c to lhs
+	// Determine sign: the signs are the same, so the solution is positive; otherwise negative
+	sign = (sign != value.sign);
+	limb = std::move(c);	//reassigns c to lhs
+	clean_up();
 	return (*this);
 }
 
-/** Subtracts value from lhs
-    @param value the value being subtracted, in base 2
+/** Adds a * b to lhs in place
+    @param value the product a * b (possibly negated)
 */
-Integer& Integer::operator-=(const Integer& value) {
-	// We create a new variable with opposite sign of value
-	Integer b = -value;
+Integer& Integer::operator+=(const expression::Product<Integer>& value) {
+	const expression::Term<Integer>& t = value.terms[0];
+	Integer scratch;
+	addmul_signed(*this, *t.a, *t.b, (t.a->sign != t.b->sign) != t.negative, scratch);
+	return (*this);
+}
 
-	// Now lhs - value becomes lhs + (-value) and we use the += operator
-	(*this) += b;
-	(*this).clean_up();
+/** Subtracts a * b from lhs in place
+    @param value the product a * b (possibly negated)
+*/
+Integer& Integer::operator-=(const expression::Product<Integer>& value) {
+	const expression::Term<Integer>& t = value.terms[0];
+	Integer scratch;
+	addmul_signed(*this, *t.a, *t.b, (t.a->sign != t.b->sign) == t.negative, scratch);
 	return (*this);
 }
 
-/** Multiplies value to lhs
-    @param value the value being multiplied, in base 2
+/** Adds a single word to lhs: one carry (or borrow) pass, without making an Integer of it
+    @param magnitude the word
+    @param negative true to subtract it instead
 */
-Integer& Integer::operator*=(const Integer& value) {
-	// Temp values:  a * b = c							Example: 39*48
-	// Equivalently: a * (temp[1] + 10*temp[2] + ... )  Example: 39*(8 + 40)
-	Integer a;        // Copy of lhs
-	a.bit = bit;
-	a.sign = sign;
-	Integer temp = value; // Amount being mulitiplied to lhs (copy of rhs)
-	temp.sign = 0;		  // Temp value is always positive; sign of solution is determined independently
-	Integer c = 0;        // Solution to multiplication of a and b
-
-	// Multiplication Operation
-	// Computed along a, starting with the last digit
-	for (size_t i = 0, n = a.bit.size(); i < n; ++i) { //credit: Prof. DeSalvo's Syle lecture
-		// If the digit is one, add b + trailing zero correction
-		if (a.bit[a.bit.size() - 1 - i] == 1) {
-			c += temp;
+void Integer::add_word(limb_t magnitude, bool negative) {
+	if (magnitude == 0) {
+		return;
+	}
+	if (limb.empty()) {
+		limb.push_back(magnitude);
+		sign = negative;
+		return;
+	}
+	if (sign == negative) { // Same signs: add to the magnitude
+		limb_t carry = limbs::add_1(limb.data(), limb.data(), limb.size(), magnitude);
+		if (carry) {
+			limb.push_back(carry);
 		}
-		// Trailing zero correction: 
-		temp.bit.push_back(0);
+		return;
+	}
+	if (limb.size() == 1 && limb[0] < magnitude) { // The word is larger: the sign flips
+		limb[0] = magnitude - limb[0];
+		sign = negative;
+		return;
 	}
+	limbs::sub_1(limb.data(), limb.data(), limb.size(), magnitude);
+	clean_up();
+}
 
-	// Determine sign
-	if (a.sign == value.sign) { // The signs are the same, so the solution is positive
-		c.sign = 0;
+/** Multiplies lhs by a single word in one pass
+    @param magnitude the word
+    @param negative true to negate the product
+*/
+void Integer::mul_word(limb_t magnitude, bool negative) {
+	if (magnitude == 0 || limb.empty()) {
+		limb.clear();
+		sign = 0;
+		return;
 	}
-	else { // The signs are different, so the solution is negative
-		c.sign = 1;
+	limb_t carry = limbs::mul_1(limb.data(), limb.data(), limb.size(), magnitude);
+	if (carry) {
+		limb.push_back(carry);
 	}
+	sign = (sign != negative);
+}
 
-	c.clean_up();
-	bit = c.bit;   //reassigns c to lhs
-	sign = c.sign;
+/** Divides a by a single word, rounding toward zero
+    @param quotient receives a / divisor; may be a
+    @param a the dividend
+    @param divisor the magnitude of the divisor; throws std::domain_error if it is zero
+    @param negative true if the divisor is negative
+    @return |a % divisor| (the remainder has the sign of a)
+*/
+Integer::limb_t Integer::divmod_word(Integer& quotient, const Integer& a, limb_t divisor, bool negative) {
+	if (divisor == 0) {
+		throw std::domain_error("Integer division by zero");
+	}
+	bool quotient_sign = (a.sign != negative);
+	std::size_t n = a.limb.size();
+	quotient.limb.resize(n); // Only changes the size of a when quotient is a
+	limb_t remainder = (n == 0) ? 0 : limbs::divrem_1(quotient.limb.data(), a.limb.data(), n, divisor);
+	quotient.sign = quotient_sign;
+	quotient.clean_up();
+	return remainder;
+}
+
+/** Divides lhs by value, rounding toward zero
+    @param value the divisor (nonzero)
+*/
+Integer& Integer::operator/=(const Integer& value) {
+	Integer remainder;
+	divmod(*this, remainder, *this, value);
+	return (*this);
+}
+
+/** Replaces lhs by the remainder of lhs / value (which has the sign of lhs)
+    @param value the divisor (nonzero)
+*/
+Integer& Integer::operator%=(const Integer& value) {
+	Integer quotient;
+	divmod(quotient, *this, *this, value);
 	return (*this);
 }
 
 /** Prefix increment: adds one to lhs
 */
 Integer& Integer::operator++() {
-	Integer one = 1;
-	(*this) += one;	//increments the object
-	return (*this);	//returns the object
+	add_word(1, false);	//increments the object
+	return (*this);		//returns the object
 }
 
 /** Postfix increment: adds one to lhs
@@ -285,9 +378,8 @@ Integer Integer::operator++(int unused) {
 /** Prefix decrement: subtracts one from lhs
 */
 Integer& Integer::operator--() {
-	Integer one = 1;
-	*this -= one;	//decrements the object
-	return *this;	//returns the object
+	add_word(1, true);	//decrements the object
+	return *this;		//returns the object
 }
 
 /** Postfix decrement: subtracts one from lhs
@@ -301,78 +393,154 @@ Integer Integer::operator--(int unused){
 /** Flips the sign
     @return the implicit parameter with opposite sign
 */
-Integer Integer::operator-() const {
+Integer Integer::operator-() const& {
 	Integer a;
-	a.bit = bit;
+	a.limb = limb;
 	a.sign = !(sign);
+	a.clean_up(); // -0 is 0
 
 	return a;
 }
 
+/** Flips the sign of a temporary, keeping its limbs
+    @return the implicit parameter with opposite sign
+*/
+Integer Integer::operator-() && {
+	sign = !(sign);
+	clean_up(); // -0 is 0
+
+	return std::move(*this);
+}
+
 /** Returns a copy of the implicit parameter
     @return the implicit parameter
 */
-Integer Integer::operator+() const {
+Integer Integer::operator+() const& {
 	Integer a;
-	a.bit = bit;
+	a.limb = limb;
 	a.sign = sign;
 
 	return a;
 }
 
+/** Returns a temporary, keeping its limbs
+    @return the implicit parameter
+*/
+Integer Integer::operator+() && {
+	return std::move(*this);
+}
+
 /** Returns the magnitude of the implicit parameter
     @return the magnitude of the implicit parameter
 */
-Integer Integer::abs() const {
+Integer Integer::abs() const& {
 	Integer a;
-	a.bit = bit;
+	a.limb = limb;
 	a.sign = 0;
 	
 	return a;
 }
 
+/** Returns the magnitude of a temporary, keeping its limbs
+    @return the magnitude of the implicit parameter
+*/
+Integer Integer::abs() && {
+	sign = 0;
+
+	return std::move(*this);
+}
+
+/** Returns the number of bits in the magnitude of the implicit parameter
+    @return the position of the highest set bit of |a|, plus one (0 for zero)
+*/
+std::size_t Integer::bit_length() const {
+	if (limb.empty()) {
+		return 0;
+	}
+	return 64 * limb.size() - __builtin_clzll(limb.back());
+}
+
+/** Builds an Integer from its limbs
+    @param magnitude the limbs of |a|, least significant first (leading zero limbs are removed)
+    @param negative true for -magnitude (ignored when the magnitude is zero)
+    @return the Integer
+*/
+Integer Integer::from_magnitude(LimbBuffer magnitude, bool negative) {
+	Integer a;
+	a.limb = std::move(magnitude);
+	a.sign = negative;
+	a.clean_up();
+
+	return a;
+}
+
+/** Returns the limbs of the magnitude
+    @return |a| as limbs, least significant first, without leading zero limbs (empty for zero)
+*/
+const LimbBuffer& Integer::magnitude() const {
+	return limb;
+}
+
+/** Returns true if the implicit parameter is negative
+    @return true if a < 0
+*/
+bool Integer::is_negative() const {
+	return sign;
+}
+
 /** Prints the lhs in base 10: "####" if positive, and "-####" if negative
     @param out specifies the type of output: cout or outputData
+
+    Small values are converted on the stack; see Radix.cpp for the conversion itself.
 */
 void Integer::print_as_int(std::ostream& out) const {
-	std::string negative_indicator = "";
-	if (sign == 1) { // If the number is negative, output is of the form -####
-		negative_indicator = "-";
+	char buffer[64];
+	ToCharsResult result = to_chars(buffer, buffer + sizeof(buffer), *this);
+	if (result.ec == std::errc()) {
+		out.write(buffer, result.ptr - buffer);
 	}
-
-	unsigned int numb = 0;
-
-	// converts from binary to decimal
-	for (size_t i = 0, n = bit.size(); i < n; ++i) { //credit: Prof. DeSalvo's Syle lecture
-		numb += bit[i] * pow(2, (bit.size() - 1 - i));
+	else { // Too long for the stack buffer
+		out << to_string(*this);
 	}
-
-	out << negative_indicator << numb;
 }
 
 /** Prints the lhs in base 2: "(#####)_2" or "-(#####)_2"
     @param out specifies the type of output: cout or outputData
 */
 void Integer::print_as_bits(std::ostream& out) const {
-	Integer a;
-	a.bit = bit;
-	a.sign = sign;
-
 	std::string negative_indicator = " ";
-	if ((sign == 1) && (bit[0] != 0)) { // If the number is negative, output is of the form -(#####)_2 unless it is zero
-		negative_indicator = "-";		// Note this assumes no leading zeros
+	if (sign == 1) { // If the number is negative, output is of the form -(#####)_2 (zero is never negative)
+		negative_indicator = "-";
 	}
 
 	out << negative_indicator << "(";
 
-	//prints the number in binary
-	for (size_t i = 0, n = bit.size(); i < n; ++i) { //credit: Prof. DeSalvo's Syle lecture
-		out << bit[i];
+	//prints the number in binary, starting with the most significant set bit
+	if (limb.empty()) {
+		out << 0;
+	}
+	for (size_t i = limb.size(); i-- > 0;) {
+		int top = 63;
+		if (i == limb.size() - 1) { // Skip the leading zeros of the most significant limb
+			while (((limb[i] >> top) & 1) == 0) {
+				--top;
+			}
+		}
+		for (int j = top; j >= 0; --j) {
+			out << ((limb[i] >> j) & 1);
+		}
 	}
 
 	out << ")_2";
 }
 
+/** Returns the number of heap allocations made by Integers so far
+    @return the running allocation count (compare two readings to count the allocations in between)
+*/
+std::size_t Integer::allocations() {
+	return LimbBuffer::allocations();
+}
+
 /** Returns true if lhs < rhs (otherwise returns false)
     @param rhs
     @return true if lhs < rhs
@@ -380,43 +548,10 @@ void Integer::print_as_bits(std::ostream& out) const {
 bool Integer::operator<(const Integer& rhs) const {
 	if (sign == rhs.sign) { // The values have the same sign, so we cannot make a quick deduction based on that.
 		if (sign == 0) {
-			// Note: Integers are stored without leading zeros, so comparing sizes can determine inequality.
-			if (bit.size() < rhs.bit.size()) { // if length lhs < length rhs ==> lhs < rhs
-				return true;
-			}
-			else if (bit.size() > rhs.bit.size()) { // if length lhs > length rhs ==> lhs > rhs
-				return false;
-			}
-			else { // length of lhs == length rhs (need to compare bitwise)
-				for (size_t i = 0, n = bit.size(); i < n; ++i) { // compares each bit, starting with the first
-					if (bit[i] < rhs.bit[i]) { // entry of lhs < entry of rhs
-						return true; // returns true and stops loop
-					}
-					else if (bit[i] > rhs.bit[i]) { // entry of lhs > entry of rhs
-						return false; // returns false and stops loop
-					}
-				}
-				return false; // if loop completes, lhs == rhs for all entries
-			}
+			return compare_magnitude(limb, rhs.limb) < 0;
 		}
 		else { // For negative numbers, a larger magnitude indicates less than: -20 < -2 < 1 < 20
-			if (bit.size() > rhs.bit.size()) { // if length lhs > length rhs ==> lhs < rhs
-				return true;
-			}
-			else if (bit.size() < rhs.bit.size()) { // if length lhs < length rhs ==> lhs > rhs
-				return false;
-			}
-			else { // length of lhs == length rhs (need to compare bitwise)
-				for (size_t i = 0, n = bit.size(); i < n; ++i) { // compares each bit, starting with the first
-					if (bit[i] > rhs.bit[i]) { // entry of lhs > entry of rhs
-						return true; // returns true and stops loop
-					}
-					else if (bit[i] < rhs.bit[i]) { // entry of lhs < entry of rhs
-						return false; // returns false and stops loop
-					}
-				}
-				return false; // if loop completes, lhs == rhs for all entries
-			}
+			return compare_magnitude(limb, rhs.limb) > 0;
 		}
 	}
 	else if (sign == 1) { // Then lhs is negative and rhs is positive ==> return true
@@ -432,23 +567,8 @@ bool Integer::operator<(const Integer& rhs) const {
     @return true if lhs == rhs
 */
 bool Integer::operator==(const Integer& rhs) const {
-	if (sign == rhs.sign) { // The values have the same sign
-		// Note: Integers are stored without leading zeros, so comparing sizes can determine equality.
-		if (bit.size() != rhs.bit.size()) { // if length lhs != length rhs ==> lhs != rhs
-			return false;
-		}
-		else { // length of lhs == length rhs (need to compare bitwise)
-			for (size_t i = 0, n = bit.size(); i < n; ++i) { // compares each bit, starting with the first
-				if (bit[i] != rhs.bit[i]) { // entry of lhs != entry of rhs
-					return false; // returns false and stops loop
-				}
-			}
-			return true; // if loop completes, lhs == rhs for all entries
-		}
-	}
-	else { // The values have different sign, so they are not equal
-		return false;
-	}
+	// The values need the same sign and (since there are no leading zeros) the same limbs
+	return (sign == rhs.sign) && (limb == rhs.limb);
 }
 
 /** And equals: changes lhs to the bit-wise comparison of lhs&rhs
@@ -456,21 +576,10 @@ bool Integer::operator==(const Integer& rhs) const {
     @return the bit-wise comparison lhs&rhs
 */
 Integer& Integer::operator&=(const Integer& rhs) {
-	Integer a = rhs; // copy of rhs
-	a.sign = rhs.sign;
-
-	while (a.bit.size() < bit.size()) { // If a is shorter than lhs, increase a to the same length with leading zeros
-		a.bit.insert(a.bit.begin(), 0);
-	}
-
-	while (bit.size() < a.bit.size()) { // If lhs is shorter than a, increase lhs to the same length with leading zeros
-		bit.insert(bit.begin(), 0);
-	}
-
-	for (size_t i = 0, n = bit.size(); i < n; ++i) { // Compares each entry and changes the lhs accordingly
-		bit[i] = bit[i] & a.bit[i];
+	if (limb.size() > rhs.limb.size()) { // Limbs beyond the length of rhs are and-ed with zero
+		limb.resize(rhs.limb.size());
 	}
-
+	limbs::and_n(limb.data(), limb.data(), rhs.limb.data(), limb.size());
 	(*this).clean_up(); //remove leading zeros
 	return (*this);
 }
@@ -480,22 +589,12 @@ Integer& Integer::operator&=(const Integer& rhs) {
     @return the bit-wise comparison lhs|rhs
 */
 Integer& Integer::operator|=(const Integer& rhs) {
-	Integer a = rhs; // copy of rhs
-	a.sign = rhs.sign;
-
-	while (a.bit.size() < bit.size()) { // If a is shorter than lhs, increase a to the same length with leading zeros
-		a.bit.insert(a.bit.begin(), 0);
-	}
-
-	while (bit.size() < a.bit.size()) { // If lhs is shorter than a, increase lhs to the same length with leading zeros
-		bit.insert(bit.begin(), 0);
+	size_t n = rhs.limb.size();
+	if (limb.size() < n) { // If lhs is shorter than rhs, increase lhs to the same length with leading zeros
+		limb.resize(n, 0);
 	}
-
-	for (size_t i = 0, n = bit.size(); i < n; ++i) { // Compares each entry and changes the lhs accordingly
-		bit[i] = bit[i] | a.bit[i];
-	}
-
-	(*this).clean_up(); //remove leading zeros
+	// The top limb of either operand stays nonzero, so there is nothing to trim
+	limbs::ior_n(limb.data(), limb.data(), rhs.limb.data(), n);
 	return (*this);
 }
 
@@ -504,65 +603,264 @@ Integer& Integer::operator|=(const Integer& rhs) {
     @return the bit-wise comparison lhs^rhs
 */
 Integer& Integer::operator^=(const Integer& rhs) {
-	Integer a = rhs; // copy of rhs
-	a.sign = rhs.sign;
-
-	while (a.bit.size() < bit.size()) { // If a is shorter than lhs, increase a to the same length with leading zeros
-		a.bit.insert(a.bit.begin(), 0);
+	size_t n = rhs.limb.size();
+	if (limb.size() < n) { // If lhs is shorter than rhs, increase lhs to the same length with leading zeros
+		limb.resize(n, 0);
 	}
-
-	while (bit.size() < a.bit.size()) { // If lhs is shorter than a, increase lhs to the same length with leading zeros
-		bit.insert(bit.begin(), 0);
-	}
-
-	for (size_t i = 0, n = bit.size(); i < n; ++i) { // Compares each entry and changes the lhs accordingly
-		bit[i] = bit[i] ^ a.bit[i];
-	}
-
-	(*this).clean_up(); //remove leading zeros
+	limbs::xor_n(limb.data(), limb.data(), rhs.limb.data(), n);
+	(*this).clean_up(); // Equal top limbs cancel
 	return (*this);
 }
 
 /** Shifts lhs left increment number of times
     @param increment the number of times to shift lhs left
+    Whole limbs move up in one pass, then a funnel shift moves the remaining increment % 64 bits, so the cost is
+    linear in the size of the result.
 */
 Integer& Integer::operator<<=(const unsigned int& increment) {
-	for (size_t i = 0; i < increment; ++i) {
-		bit.push_back(0);
+	if (limb.empty() || increment == 0) { // Zero stays zero
+		return (*this);
+	}
+	size_t words = increment / 64;
+	unsigned bits = increment % 64;
+	size_t n = limb.size();
+	limb.resize(n + words + 1);
+	limb_t* r = limb.data();
+	if (bits == 0) {
+		std::copy_backward(r, r + n, r + n + words);
+		r[n + words] = 0;
+	}
+	else {
+		r[n + words] = limbs::lshift(r + words, r, n, bits);
+	}
+	std::fill(r, r + words, limb_t(0));
+	if (r[n + words] == 0) { // At most the one spare limb is zero
+		limb.pop_back();
 	}
-	(*this).clean_up();
 	return (*this);
 }
 
 /** Shifts lhs right increment number of times
     @param increment the number of times to shift lhs right
+    Shifts the magnitude, so negative values are rounded toward zero. Like <<=, the cost is linear in the size of
+    the result.
 */
 Integer& Integer::operator>>=(const unsigned int& increment) {
-	for (size_t i = 0; i < increment; ++i) {
-		bit.pop_back();
+	size_t words = increment / 64;
+	unsigned bits = increment % 64;
+	if (words >= limb.size()) { // Every bit is shifted out
+		limb.clear();
+		sign = 0;
+		return (*this);
+	}
+	size_t n = limb.size() - words;
+	limb_t* r = limb.data();
+	if (bits == 0) {
+		std::copy(r + words, r + words + n, r);
 	}
-	(*this).clean_up();
+	else {
+		limbs::rshift(r, r + words, n, bits);
+	}
+	limb.resize(n);
+	(*this).clean_up(); // Only the top limb can have become zero
 	return (*this);
 }
 
-Integer Integer::operator~() const {
-	Integer a; // Copy the implicit parameter
-	a.bit = bit;
-	a.sign = !(sign);
-
-	a.bit.flip();
-	a.clean_up();
+/** Negation: flips every bit of the magnitude (up to its most significant bit) and the sign
+    @return the negated value
+*/
+Integer Integer::operator~() const& {
+	Integer a;
+	a.limb.resize(limb.size());
+	limbs::com_n(a.limb.data(), limb.data(), limb.size());
+	a.sign = sign;
+	a.complement_top(limb.empty() ? 0 : limb.back());
 	return a;
 }
 
-/** Removes leading zeros, if the number is not 0
+/** Negation of a temporary, flipping its limbs in place
+    @return the negated value
+*/
+Integer Integer::operator~() && {
+	limb_t top = limb.empty() ? 0 : limb.back();
+	limbs::com_n(limb.data(), limb.data(), limb.size());
+	complement_top(top);
+	return std::move(*this);
+}
+
+/** Finishes ~: after the limbs have been complemented, clears the bits above the most significant bit of the
+    original value and flips the sign
+    @param top the original top limb (0 for zero, which is stored as the single bit 0 and flips to 1)
+*/
+void Integer::complement_top(limb_t top) {
+	sign = !(sign);
+	if (top == 0) {
+		limb.clear();
+		limb.push_back(1);
+		return;
+	}
+	int width = 64 - __builtin_clzll(top); // number of significant bits in the top limb
+	if (width < 64) { // Bits above the most significant bit are not part of the number
+		limb.back() &= (limb_t(1) << width) - 1;
+	}
+	clean_up();
+}
+
+/** Removes leading zeros; zero is always stored as positive
 */
 void Integer::clean_up() {
-	for (size_t i = 0, n = bit.size(); i < n; ++i) {
-		if (bit[0] == 0 && bit.size() != 1) { //check if lhs has a leading zero (and isn't zero)
-			bit.erase(bit.begin()); //remove the zero
+	limb.resize(limbs::normalized_size(limb.data(), limb.size())); // One scan down from the top, one resize
+	if (limb.empty()) {
+		sign = 0;
+	}
+}
+
+/** Adds a and b, storing the result in dst
+    @param dst receives a + b; may be the same object as a or b
+    @param a
+    @param b
+*/
+void add(Integer& dst, const Integer& a, const Integer& b) {
+	Integer::add_signed(dst, a, b, b.sign);
+}
+
+/** Subtracts b from a, storing the result in dst
+    @param dst receives a - b; may be the same object as a or b
+    @param a
+    @param b
+*/
+void sub(Integer& dst, const Integer& a, const Integer& b) {
+	Integer::add_signed(dst, a, b, !b.sign);
+}
+
+/** Divides a by b, like the built-in integer types: the quotient rounds toward zero and the remainder has the sign of a
+    @param quotient receives a / b; may be a or b
+    @param remainder receives a % b; may be a or b (but not quotient)
+    @param a the dividend
+    @param b the divisor; throws std::domain_error if it is zero
+
+    The work is done by limbs::divrem, which picks single-limb, schoolbook or Burnikel-Ziegler division by size.
+*/
+void divmod(Integer& quotient, Integer& remainder, const Integer& a, const Integer& b) {
+	if (b.limb.empty()) {
+		throw std::domain_error("Integer division by zero");
+	}
+	bool quotient_sign = (a.sign != b.sign);
+	bool remainder_sign = a.sign;
+
+	if (Integer::compare_magnitude(a.limb, b.limb) < 0) { // |a| < |b|: the quotient is zero
+		if (&remainder != &a) {
+			remainder = a;
 		}
+		quotient = 0;
+		return;
 	}
+
+	std::size_t n = a.limb.size();
+	std::size_t m = b.limb.size();
+	LimbBuffer q, r;
+	q.resize(n - m + 1);
+	r.resize(m);
+	limbs::divrem(q.data(), r.data(), a.limb.data(), n, b.limb.data(), m);
+
+	quotient.limb = std::move(q);
+	quotient.sign = quotient_sign;
+	quotient.clean_up();
+	remainder.limb = std::move(r);
+	remainder.sign = remainder_sign;
+	remainder.clean_up();
+}
+
+/** Divides a by a built-in integer, like the built-in types: the quotient rounds toward zero and the remainder
+    has the sign of a
+    @param quotient receives a / b; may be a
+    @param a the dividend
+    @param b the divisor; throws std::domain_error if it is zero
+    @return a % b
+*/
+std::int64_t divmod(Integer& quotient, const Integer& a, std::int64_t b) {
+	bool negative = a.sign;
+	Integer::limb_t remainder = Integer::divmod_word(quotient, a, Integer::word_magnitude(b), b < 0);
+	return negative ? -std::int64_t(remainder) : std::int64_t(remainder); // |remainder| < |b|, so it fits
+}
+
+/** Adds a * b to dst (GMP's addmul); a single-limb factor is multiplied straight into the limbs of dst
+    @param dst receives dst + a * b; may be the same object as a or b
+    @param a
+    @param b
+*/
+void addmul(Integer& dst, const Integer& a, const Integer& b) {
+	Integer scratch;
+	Integer::addmul_signed(dst, a, b, a.sign != b.sign, scratch);
+}
+
+/** Subtracts a * b from dst (GMP's submul); a single-limb factor is multiplied straight into the limbs of dst
+    @param dst receives dst - a * b; may be the same object as a or b
+    @param a
+    @param b
+*/
+void submul(Integer& dst, const Integer& a, const Integer& b) {
+	Integer scratch;
+	Integer::addmul_signed(dst, a, b, a.sign == b.sign, scratch);
+}
+
+/** Adds a signed product to dst
+    @param dst receives dst + (a * b with sign negative); may be the same object as a or b
+    @param a
+    @param b
+    @param negative the sign used for the product
+    @param scratch holds the product when it cannot be accumulated straight into dst (so callers can reuse it)
+
+    When one factor has a single limb and the other is not dst, the product is accumulated with one addmul_1 (or
+    submul_1) pass over dst. If submul_1 takes more than dst holds, the limbs hold the two's complement of the
+    result, which is negated once at the end. Otherwise the product goes through scratch.
+*/
+void Integer::addmul_signed(Integer& dst, const Integer& a, const Integer& b, bool negative, Integer& scratch) {
+	if (a.limb.empty() || b.limb.empty()) {
+		return;
+	}
+	const Integer* x = &a; // The longer factor
+	const Integer* y = &b;
+	if (x->limb.size() < y->limb.size()) {
+		x = &b;
+		y = &a;
+	}
+	if (y->limb.size() != 1 || x == &dst) {
+		scratch.limb.resize(x->limb.size() + y->limb.size());
+		if (x == y || x->limb == y->limb) {
+			limbs::sqr(scratch.limb.data(), x->limb.data(), x->limb.size());
+		}
+		else {
+			limbs::mul(scratch.limb.data(), x->limb.data(), x->limb.size(), y->limb.data(), y->limb.size());
+		}
+		scratch.sign = negative;
+		scratch.clean_up();
+		add_signed(dst, dst, scratch, scratch.sign);
+		return;
+	}
+
+	limb_t w = y->limb[0]; // Read before dst changes, since y may be dst
+	std::size_t n = x->limb.size();
+	if (dst.limb.empty()) {
+		dst.sign = negative;
+	}
+	if (dst.sign == negative) { // Same signs: add to the magnitude
+		std::size_t size = std::max(dst.limb.size(), n) + 1;
+		dst.limb.resize(size);
+		limb_t carry = limbs::addmul_1(dst.limb.data(), x->limb.data(), n, w);
+		limbs::add_1(dst.limb.data() + n, dst.limb.data() + n, size - n, carry);
+		dst.clean_up();
+		return;
+	}
+	std::size_t size = std::max(dst.limb.size(), n + 1);
+	dst.limb.resize(size);
+	limb_t borrow = limbs::submul_1(dst.limb.data(), x->limb.data(), n, w);
+	if (limbs::sub_1(dst.limb.data() + n, dst.limb.data() + n, size - n, borrow)) { // |a * b| > |dst|
+		limbs::com_n(dst.limb.data(), dst.limb.data(), size);
+		limbs::add_1(dst.limb.data(), dst.limb.data(), size, 1);
+		dst.sign = negative;
+	}
+	dst.clean_up();
 }
 
 /** Adds a and b; returns the result
@@ -570,8 +868,40 @@ void Integer::clean_up() {
     @param b of type Integer
     @return a + b
 */
-Integer operator+(Integer a, const Integer& b) {
-	return a += b;
+Integer operator+(const Integer& a, const Integer& b) {
+	Integer result; // Written in one pass, rather than copying a and then adding b
+	add(result, a, b);
+	return result;
+}
+
+/** Adds a temporary a and b, reusing the limbs of a
+    @param a
+    @param b
+    @return a + b
+*/
+Integer operator+(Integer&& a, const Integer& b) {
+	a += b;
+	return std::move(a);
+}
+
+/** Adds a and a temporary b, reusing the limbs of b
+    @param a
+    @param b
+    @return a + b
+*/
+Integer operator+(const Integer& a, Integer&& b) {
+	b += a;
+	return std::move(b);
+}
+
+/** Adds two temporaries, reusing the limbs of a
+    @param a
+    @param b
+    @return a + b
+*/
+Integer operator+(Integer&& a, Integer&& b) {
+	a += b;
+	return std::move(a);
 }
 
 /** Subtracts a and b; returns the result
@@ -579,17 +909,253 @@ Integer operator+(Integer a, const Integer& b) {
     @param b of type Integer
     @return a - b
 */
-Integer operator-(Integer a, const Integer& b) {
-	return a -= b;
+Integer operator-(const Integer& a, const Integer& b) {
+	Integer result;
+	sub(result, a, b);
+	return result;
+}
+
+/** Subtracts b from a temporary a, reusing the limbs of a
+    @param a
+    @param b
+    @return a - b
+*/
+Integer operator-(Integer&& a, const Integer& b) {
+	a -= b;
+	return std::move(a);
+}
+
+/** Subtracts a temporary b from a, reusing the limbs of b
+    @param a
+    @param b
+    @return a - b
+*/
+Integer operator-(const Integer& a, Integer&& b) {
+	sub(b, a, b);
+	return std::move(b);
+}
+
+/** Subtracts two temporaries, reusing the limbs of a
+    @param a
+    @param b
+    @return a - b
+*/
+Integer operator-(Integer&& a, Integer&& b) {
+	a -= b;
+	return std::move(a);
+}
+
+/** Multiplies a and b; the product is computed when it is assigned, so that sums of products can be fused
+    @param a
+    @param b
+    @return an expression for a * b (see Expression.h)
+*/
+expression::Product<Integer> operator*(const Integer& a, const Integer& b) {
+	return expression::product(a, b);
+}
+
+/** Computes a sum of products (and values) of Integers: the first product is computed straight into the result, and
+    every other product is accumulated into it with addmul (through one scratch buffer), so the sum makes at most two
+    allocations of its own (and a single product at most one). Products of at least thresholds.mul_karatsuba limbs
+    also allocate the scratch space of Karatsuba, Toom-3 or the transforms (which Integer::allocations() counts too)
+    @param dst receives the sum
+    @param terms the terms of the sum (none of them is dst)
+    @param n the number of terms
+*/
+void expression::Evaluate<Integer>::sum(Integer& dst, const Term<Integer>* terms, std::size_t n) {
+	std::size_t size = 0; // The largest term
+	for (std::size_t i = 0; i < n; ++i) {
+		size = std::max(size, terms[i].a->limb.size() + (terms[i].b ? terms[i].b->limb.size() : 0));
+	}
+
+	Integer result;
+	result.limb.reserve(size + (n > 1)); // A limb of room for the carries
+	Integer p;
+	for (std::size_t i = 0; i < n; ++i) {
+		const Integer& a = *terms[i].a;
+		if (!terms[i].b) {
+			Integer::add_signed(result, result, a, a.sign != terms[i].negative);
+			continue;
+		}
+		const Integer& b = *terms[i].b;
+		bool negative = (a.sign != b.sign) != terms[i].negative;
+		if (!result.limb.empty()) {
+			Integer::addmul_signed(result, a, b, negative, p);
+			continue;
+		}
+		if (a.limb.empty() || b.limb.empty()) {
+			continue;
+		}
+		result.limb.resize(a.limb.size() + b.limb.size()); // Nothing to add to yet: multiply into the result
+		if (&a == &b || a.limb == b.limb) {
+			limbs::sqr(result.limb.data(), a.limb.data(), a.limb.size());
+		}
+		else {
+			limbs::mul(result.limb.data(), a.limb.data(), a.limb.size(), b.limb.data(), b.limb.size());
+		}
+		result.sign = negative;
+		result.clean_up();
+	}
+	dst = std::move(result);
 }
 
-/** Multiplies a and b; returns the result
+/** Divides a by b; returns the result
     @param a
     @param b
-    @return a * b
+    @return a / b (rounded toward zero)
 */
-Integer operator*(Integer a, const Integer& b) {
-	return a *= b;
+Integer operator/(Integer a, const Integer& b) {
+	a /= b;
+	return a;
+}
+
+/** Returns the remainder of a / b
+    @param a
+    @param b
+    @return a % b (with the sign of a)
+*/
+Integer operator%(Integer a, const Integer& b) {
+	a %= b;
+	return a;
+}
+
+/** Returns the magnitude of a (so that abs can be called the same way for Integer and the built-in types)
+    @param a
+    @return |a|
+*/
+Integer abs(const Integer& a) {
+	return a.abs();
+}
+
+/** Returns the magnitude of a temporary, reusing its limbs
+    @param a
+    @return |a|
+*/
+Integer abs(Integer&& a) {
+	return std::move(a).abs();
+}
+
+/** Returns the number of bits in the magnitude of a (so that it can be called the same way as for the built-in types)
+    @param a
+    @return the number of bits in |a| (0 for zero)
+*/
+std::size_t bit_length(const Integer& a) {
+	return a.bit_length();
+}
+
+/** Divides two Integers into the nearest double (ties to even), without computing the whole quotient
+    @param numerator
+    @param denominator
+    @return the correctly rounded quotient; infinity if it is too large (or the denominator is 0), 0 if it is too
+    small, and NaN for 0/0
+
+    With a and b the bit lengths, numerator * 2^(55 - a + b) / denominator has 55 or 56 bits; dividing the shifted
+    values gives those bits (a one-limb quotient, so the division takes time linear in the operands) and the remainder
+    tells whether any nonzero bits are left below them. Quotients far outside the range of double are not divided.
+*/
+double to_double(const Integer& numerator, const Integer& denominator) {
+	bool negative = (numerator.is_negative() != denominator.is_negative());
+	long a = long(numerator.bit_length());
+	long b = long(denominator.bit_length());
+	if (b == 0) {
+		double infinity = std::numeric_limits<double>::infinity();
+		return (a == 0) ? std::numeric_limits<double>::quiet_NaN() : (negative ? -infinity : infinity);
+	}
+	if (a == 0 || a - b < -1076) { // Below half the smallest subnormal
+		return negative ? -0.0 : 0.0;
+	}
+	if (a - b > 1025) { // At least 2^1025
+		return negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+	}
+	long shift = 55 - a + b;
+	Integer quotient;
+	Integer remainder;
+	if (shift >= 0) {
+		divmod(quotient, remainder, numerator << static_cast<unsigned int>(shift), denominator);
+	}
+	else {
+		divmod(quotient, remainder, numerator, denominator << static_cast<unsigned int>(-shift));
+	}
+	return words::round_quotient(quotient.magnitude()[0], remainder != 0, shift, negative);
+}
+
+namespace {
+
+/** The leading 64 bits of |a| as a double (a != 0)
+	@param a
+	@return |a| / 2^(bit_length(a) - 64), truncated to 64 bits and then rounded to a double (so within a relative
+	2^-53 + 2^-63 of the exact value)
+*/
+double leading_bits(const Integer& a) {
+	const LimbBuffer& limbs = a.magnitude();
+	std::size_t n = limbs.size();
+	int shift = __builtin_clzll(limbs[n - 1]);
+	Integer::limb_t top = limbs[n - 1] << shift;
+	if (shift != 0 && n > 1) {
+		top |= limbs[n - 2] >> (64 - shift);
+	}
+	return double(top);
+}
+
+} // namespace
+
+/** Compares a/b with c/d (b and d positive) in stages, multiplying only when the cheaper stages cannot decide
+	@param a
+	@param b (positive)
+	@param c
+	@param d (positive)
+	@return -1, 0 or 1 as a/b <, ==, > c/d
+
+	1. Signs: a negative, zero or positive a/b is ordered by the signs of a and c alone.
+	2. Sizes: |a|/b lies in (2^(e - 1), 2^(e + 1)) for e = bit_length(a) - bit_length(b), so exponents that differ
+	   by 2 or more decide.
+	3. Estimate: the ratio of the two quotients, from the leading 64 bits of each operand in double arithmetic, is
+	   within a relative 2^-50 of the exact ratio (seven roundings of 2^-53, four truncations of 2^-63), so a ratio
+	   more than 2^-48 away from 1 decides.
+	4. Only quotients that agree to about 48 bits are compared exactly, as |a|*d against |c|*b.
+	Sorting distinct values almost never reaches the last stage, so it needs no multiplications or allocations.
+*/
+int compare_quotients(const Integer& a, const Integer& b, const Integer& c, const Integer& d) {
+	int sign_a = a.is_negative() ? -1 : (a.magnitude().empty() ? 0 : 1);
+	int sign_c = c.is_negative() ? -1 : (c.magnitude().empty() ? 0 : 1);
+	if (sign_a != sign_c || sign_a == 0) {
+		return (sign_a > sign_c) - (sign_a < sign_c);
+	}
+
+	long e = (long(a.bit_length()) - long(b.bit_length())) - (long(c.bit_length()) - long(d.bit_length()));
+	if (e >= 2) {
+		return sign_a; // |a/b| > |c/d|
+	}
+	if (e <= -2) {
+		return -sign_a;
+	}
+
+	double ratio = std::ldexp((leading_bits(a) / leading_bits(b)) / (leading_bits(c) / leading_bits(d)), int(e));
+	const double tolerance = std::ldexp(1.0, -48);
+	if (ratio > 1 + tolerance) {
+		return sign_a;
+	}
+	if (ratio < 1 - tolerance) {
+		return -sign_a;
+	}
+
+	Integer x = a * d;
+	Integer y = c * b;
+	return (y < x) - (x < y);
+}
+
+/** Hashes an Integer a limb at a time: each limb is xored into the hash, which is then mixed by a 64 x 64 -> 128-bit
+	multiplication (words::hash_mix), so every bit of every limb reaches every bit of the result
+	@param a
+	@return the hash (the same for equal values, as the magnitude has no leading zero limbs and zero is positive)
+*/
+std::size_t hash_value(const Integer& a) {
+	const LimbBuffer& limbs = a.magnitude();
+	std::uint64_t h = limbs.size() ^ (a.is_negative() ? words::hash_constants[1] : 0);
+	for (std::size_t i = 0; i < limbs.size(); ++i) {
+		h = words::hash_mix(h ^ limbs[i], words::hash_constants[0]);
+	}
+	return std::size_t(words::hash_mix(h, words::hash_constants[1]));
 }
 
 /** Returns true if lhs != rhs (otherwise, false)
@@ -634,7 +1200,8 @@ bool operator>=(const Integer& lhs, const Integer& rhs) {
     @return a&b (bit-wise comparison)
 */
 Integer operator&(Integer a, const Integer& b){
-	return a &= b;
+	a &= b;
+	return a;
 }
 
 /** Returns the bit-wise result of a|b
@@ -643,7 +1210,8 @@ Integer operator&(Integer a, const Integer& b){
     @return a|b (bit-wise comparison)
 */
 Integer operator|(Integer a, const Integer& b) {
-	return a |= b;
+	a |= b;
+	return a;
 }
 
 /** Returns the bit-wise result of a^b
@@ -652,7 +1220,8 @@ Integer operator|(Integer a, const Integer& b) {
     @return a^b (bit-wise comparison)
 */
 Integer operator^(Integer a, const Integer& b) {
-	return a ^= b;
+	a ^= b;
+	return a;
 }
 
 /** Returns a shifted left increment number of times
@@ -660,14 +1229,16 @@ Integer operator^(Integer a, const Integer& b) {
     @param increment
     @return a shifted left increment number of times
 */
-Integer operator<<(Integer& a, const unsigned int& increment) {
-	return a <<= increment;
+Integer operator<<(Integer a, const unsigned int& increment) {
+	a <<= increment;
+	return a;
 }
 /** Returns a shifted right increment number of times
     @param a
     @param increment
     @return a shifted right increment number of times
 */
-Integer operator>>(Integer& a, const unsigned int& increment) {
-	return (a >>= increment);
+Integer operator>>(Integer a, const unsigned int& increment) {
+	a >>= increment;
+	return a;
 }
\ No newline at end of file
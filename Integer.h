@@ -6,6 +6,11 @@
 	Positive and negative integer types are stored as objects of a class Integer so that they can be:
 	1. added, subtracted, or multiplied:	a + b; a - b; a * b;
 	1a.										a += b; a -= b; a *= b;
+	1b.										add(c, a, b); sub(c, a, b); addmul(c, a, b); submul(c, a, b);
+	1c. divided (truncating toward zero):	a / b; a % b; a /= b; a %= b; divmod(q, r, a, b);
+	1d. combined with a built-in integer:	a += 5; a -= 5; a *= 5; a /= 5; a %= 5; divmod(q, a, 5);
+	1e. greatest common divisor:			gcd(a, b); xgcd(g, s, t, a, b); (see Gcd.h)
+	1f. sums of products, fused:			x = a*b + c*d; x += a*b; dot(first1, last1, first2); (see Expression.h)
 	2. incremented:							++a; a++; --a; a--;
 	3. shifted:								a << increment; a >> increment;
 	3a.										a <<= increment; a >>= increment;
@@ -14,6 +19,10 @@
 	6. compared bitwise:					a & b; a | b; a ^ b;
 	6a.										a &= b; a |= b; a ^= b;
 	7. displayed in base 10 or base 2:		a.print_as_int(); a.print_as_bits();
+	7a. converted to decimal text:			to_string(a); to_chars(first, last, a); (see Radix.cpp)
+	7b. divided into the nearest double:	to_double(a, b);
+	8. read in base 10, 16, 8 or 2:			std::cin >> a; from_chars(first, last, a, base);
+	9. hashed, a limb at a time:			std::hash<Integer>()(a); (so Integers can be keys of unordered containers)
 
 	Additional useful variations of the above are also included.
 */
@@ -21,12 +30,23 @@
 #ifndef INTEGER_H
 #define INTEGER_H
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include "Expression.h"
+#include "LimbBuffer.h"
 
 /** @class Integer
-	@brief Stores an integer value using a collection of bits and a reserved signed bit.
+	@brief Stores an integer value using a collection of 64-bit limbs and a reserved signed bit.
 
-Stores integer values as vectors of type bool, using the sign and magnitude format. (The sign is stored separately).
+Stores integer values as vectors of 64-bit words ("limbs"), using the sign and magnitude format. (The sign is stored separately).
+Limbs are little-endian: limb[0] holds the least significant 64 bits. The magnitude never has a leading zero limb,
+so zero is stored as an empty vector with a positive sign. Values of up to two limbs are stored inside the object
+(see LimbBuffer.h), so small Integers never allocate.
 See file description (above) for possible manipulations of Integer type variables.
 
 */
@@ -34,6 +54,18 @@ class Integer {
 public:
 	friend std::ostream& operator<<(std::ostream& out, const Integer& i);
 	friend std::istream& operator>>(std::istream& in, Integer& i);
+	friend void add(Integer& dst, const Integer& a, const Integer& b);
+	friend void sub(Integer& dst, const Integer& a, const Integer& b);
+	friend void divmod(Integer& quotient, Integer& remainder, const Integer& a, const Integer& b);
+	friend std::int64_t divmod(Integer& quotient, const Integer& a, std::int64_t b);
+	friend void addmul(Integer& dst, const Integer& a, const Integer& b);
+	friend void submul(Integer& dst, const Integer& a, const Integer& b);
+	friend struct expression::Evaluate<Integer>;
+
+	typedef LimbBuffer::limb_t limb_t; // One word of the magnitude
+
+	template<typename W>
+	using if_word = typename std::enable_if<std::is_integral<W>::value, Integer&>::type; // W is a built-in integer
 
 	// Constructors
 	Integer();		// Defaults to zero
@@ -43,21 +75,53 @@ public:
 	Integer& operator+=(const Integer& value); // Adds value to lhs and returns lhs
 	Integer& operator-=(const Integer& value); // Subtracts value from lhs and returns lhs
 	Integer& operator*=(const Integer& value); // Multiplies value to lhs and returns lhs
-	//TODO: dividing Integers (for use in fraction class)
+	Integer& operator/=(const Integer& value); // Divides lhs by value (rounding toward zero) and returns lhs
+	Integer& operator%=(const Integer& value); // Replaces lhs by the remainder of lhs / value and returns lhs
+
+	template<std::size_t N>
+	Integer& operator+=(const expression::Sum<Integer, N>& value); // Adds a sum of products in one pass
+	template<std::size_t N>
+	Integer& operator-=(const expression::Sum<Integer, N>& value); // Subtracts a sum of products in one pass
+	Integer& operator+=(const expression::Product<Integer>& value); // Adds a * b in place (see addmul)
+	Integer& operator-=(const expression::Product<Integer>& value); // Subtracts a * b in place (see submul)
+
+	// Built-in integers of any type are used as a single word, without being converted to an Integer first
+	template<typename W>
+	if_word<W> operator+=(W value); // Adds value to lhs and returns lhs
+	template<typename W>
+	if_word<W> operator-=(W value); // Subtracts value from lhs and returns lhs
+	template<typename W>
+	if_word<W> operator*=(W value); // Multiplies value to lhs and returns lhs
+	template<typename W>
+	if_word<W> operator/=(W value); // Divides lhs by value (rounding toward zero) and returns lhs
+	template<typename W>
+	if_word<W> operator%=(W value); // Replaces lhs by the remainder of lhs / value and returns lhs
 
 	Integer& operator++();			// Prefix increment
 	Integer operator++(int unused); // Postfix increment
 	Integer& operator--();			// Prefix decrement
 	Integer operator--(int unused);	// Postfix decrement
 
-	Integer operator-() const; // -a: flips the sign of a
-	Integer operator+() const; // +a: returns a copy of a
-	Integer abs() const;       // |a|: takes the magnitude of a
+	// Unary operators on a temporary (or std::move(a)) reuse its limbs instead of copying them
+	Integer operator-() const&; // -a: flips the sign of a
+	Integer operator-() &&;
+	Integer operator+() const&; // +a: returns a copy of a
+	Integer operator+() &&;
+	Integer abs() const&;		// |a|: takes the magnitude of a
+	Integer abs() &&;
+	std::size_t bit_length() const; // Number of bits in |a| (0 for zero)
 
 	// Accessors
 	void print_as_int(std::ostream& out) const;  // Prints the lhs in base 10
 	void print_as_bits(std::ostream& out) const; // Prints the lhs in base 2
 
+	static std::size_t allocations(); // Number of heap allocations made by Integers so far (for measuring)
+
+	// Representation (for algorithms that work on the limbs directly)
+	static Integer from_magnitude(LimbBuffer magnitude, bool negative = false); // Builds +magnitude or -magnitude
+	const LimbBuffer& magnitude() const; // The limbs of |a|, least significant first, without leading zero limbs
+	bool is_negative() const;			 // True if a < 0
+
 	// Comparisons
 	bool operator<(const Integer& rhs) const;	// True if lhs < rhs
 	bool operator==(const Integer& rhs) const;  // True if lhs == rhs
@@ -70,18 +134,162 @@ public:
 	Integer& operator<<=(const unsigned int& increment); // Shift up: shifts lhs left increment number of times
 	Integer& operator>>=(const unsigned int& increment); // Shift down: shifts lhs right increment number of times
 
-	Integer operator~() const; // Negation: flips all the bits
+	Integer operator~() const&; // Negation: flips all the bits
+	Integer operator~() &&;
 
 private:
-	void clean_up(); // Removes leading zeros
+	void clean_up(); // Removes leading zero limbs (and makes zero positive)
+	void complement_top(limb_t top); // Finishes ~ once the limbs are complemented (top is the original top limb)
 
-	std::vector<bool> bit;
+	static int compare_magnitude(const LimbBuffer& a, const LimbBuffer& b); // -1, 0 or 1 as |a| <, ==, > |b|
+	static void add_signed(Integer& dst, const Integer& a, const Integer& b, bool b_sign); // dst = a + (b with sign b_sign)
+	static void addmul_signed(Integer& dst, const Integer& a, const Integer& b, bool negative, Integer& scratch);
+
+	// A built-in integer as a magnitude and a sign
+	template<typename W>
+	static limb_t word_magnitude(W value) { return is_negative_word(value) ? limb_t(0) - limb_t(value) : limb_t(value); }
+	template<typename W>
+	static bool is_negative_word(W value) { return std::is_signed<W>::value && value < W(0); }
+
+	void add_word(limb_t magnitude, bool negative); // lhs += magnitude (or -= if negative)
+	void mul_word(limb_t magnitude, bool negative); // lhs *= magnitude (negated if negative)
+	static limb_t divmod_word(Integer& quotient, const Integer& a, limb_t divisor, bool negative); // Returns |a % d|
+
+	LimbBuffer limb; // magnitude, least significant limb first
 	bool sign; // zero is positive; 1 indicates negative
 };
 
-Integer operator+(Integer a, const Integer& b); // Adds a + b
-Integer operator-(Integer a, const Integer& b); // Subtracts a - b
-Integer operator*(Integer a, const Integer& b); // Multiplies a * b
+namespace expression {
+
+/** Computes sums of products of Integers into one buffer (Integer.cpp)
+*/
+template<>
+struct Evaluate<Integer> {
+	static void sum(Integer& dst, const Term<Integer>* terms, std::size_t n);
+};
+
+} // namespace expression
+
+/** Adds a sum of products to lhs, computing the whole sum into one buffer
+    @param value an expression such as a*b or a*b - c*d
+    @return reference to lhs
+*/
+template<std::size_t N>
+Integer& Integer::operator+=(const expression::Sum<Integer, N>& value) {
+	return (*this) = (*this) + value;
+}
+
+/** Subtracts a sum of products from lhs, computing the whole difference into one buffer
+    @param value an expression such as a*b or a*b - c*d
+    @return reference to lhs
+*/
+template<std::size_t N>
+Integer& Integer::operator-=(const expression::Sum<Integer, N>& value) {
+	return (*this) = (*this) - value;
+}
+
+/** Adds a built-in integer to lhs
+    @param value of any built-in integer type
+    @return reference to lhs
+*/
+template<typename W>
+Integer::if_word<W> Integer::operator+=(W value) {
+	add_word(word_magnitude(value), is_negative_word(value));
+	return (*this);
+}
+
+/** Subtracts a built-in integer from lhs
+    @param value of any built-in integer type
+    @return reference to lhs
+*/
+template<typename W>
+Integer::if_word<W> Integer::operator-=(W value) {
+	add_word(word_magnitude(value), !is_negative_word(value));
+	return (*this);
+}
+
+/** Multiplies lhs by a built-in integer
+    @param value of any built-in integer type
+    @return reference to lhs
+*/
+template<typename W>
+Integer::if_word<W> Integer::operator*=(W value) {
+	mul_word(word_magnitude(value), is_negative_word(value));
+	return (*this);
+}
+
+/** Divides lhs by a built-in integer, rounding toward zero
+    @param value of any built-in integer type (nonzero)
+    @return reference to lhs
+*/
+template<typename W>
+Integer::if_word<W> Integer::operator/=(W value) {
+	divmod_word(*this, *this, word_magnitude(value), is_negative_word(value));
+	return (*this);
+}
+
+/** Replaces lhs by the remainder of lhs / value (which has the sign of lhs)
+    @param value of any built-in integer type (nonzero)
+    @return reference to lhs
+*/
+template<typename W>
+Integer::if_word<W> Integer::operator%=(W value) {
+	bool negative = sign;
+	limb_t remainder = divmod_word(*this, *this, word_magnitude(value), is_negative_word(value)); // lhs is the quotient
+	limb.clear();
+	sign = 0;
+	add_word(remainder, negative);
+	return (*this);
+}
+
+void add(Integer& dst, const Integer& a, const Integer& b); // dst = a + b (dst may be a or b)
+void sub(Integer& dst, const Integer& a, const Integer& b); // dst = a - b (dst may be a or b)
+void divmod(Integer& quotient, Integer& remainder, const Integer& a, const Integer& b); // a = quotient*b + remainder
+std::int64_t divmod(Integer& quotient, const Integer& a, std::int64_t b); // Returns a % b; quotient = a / b
+void addmul(Integer& dst, const Integer& a, const Integer& b); // dst += a * b (without a temporary product)
+void submul(Integer& dst, const Integer& a, const Integer& b); // dst -= a * b (without a temporary product)
+
+// Binary operators reuse the limbs of a temporary operand (a is taken by value, so that it can be moved in)
+Integer operator+(const Integer& a, const Integer& b); // Adds a + b
+Integer operator+(Integer&& a, const Integer& b);
+Integer operator+(const Integer& a, Integer&& b);
+Integer operator+(Integer&& a, Integer&& b);
+Integer operator-(const Integer& a, const Integer& b); // Subtracts a - b
+Integer operator-(Integer&& a, const Integer& b);
+Integer operator-(const Integer& a, Integer&& b);
+Integer operator-(Integer&& a, Integer&& b);
+expression::Product<Integer> operator*(const Integer& a, const Integer& b); // Multiplies a * b (when assigned)
+Integer operator/(Integer a, const Integer& b); // Divides a / b (rounding toward zero)
+Integer operator%(Integer a, const Integer& b); // Remainder a % b (same sign as a)
+Integer abs(const Integer& a);					 // |a|
+Integer abs(Integer&& a);
+std::size_t bit_length(const Integer& a);		 // Number of bits in |a|
+double to_double(const Integer& numerator, const Integer& denominator); // numerator/denominator, correctly rounded
+int compare_quotients(const Integer& a, const Integer& b, const Integer& c, const Integer& d); // Sign of a/b - c/d
+std::size_t hash_value(const Integer& a); // A hash of the sign and the limbs (equal values hash equally)
+
+/** @struct ToCharsResult
+	@brief The result of to_chars: where the text ends, and whether it fit (like std::to_chars_result in C++17)
+*/
+struct ToCharsResult {
+	char* ptr;	  // One past the last character written (last if the buffer was too small)
+	std::errc ec; // std::errc() on success, std::errc::value_too_large if the buffer was too small
+};
+
+/** @struct FromCharsResult
+	@brief The result of from_chars: where the number ends, and whether there was one (like std::from_chars_result)
+*/
+struct FromCharsResult {
+	const char* ptr; // The first character that is not part of the number (first if there was no number)
+	std::errc ec;	 // std::errc() on success, std::errc::invalid_argument if there was no number
+};
+
+ToCharsResult to_chars(char* first, char* last, const Integer& value); // Writes value in base 10 (Radix.cpp)
+std::string to_string(const Integer& value);							// value in base 10
+FromCharsResult from_chars(const char* first, const char* last, Integer& value, int base = 10); // Reads a value
+
+Integer gcd(const Integer& a, const Integer& b);									  // Greatest common divisor (Gcd.cpp)
+void xgcd(Integer& g, Integer& s, Integer& t, const Integer& a, const Integer& b); // g = gcd(a, b) = s*a + t*b
 
 bool operator!=(const Integer& lhs, const Integer& rhs); // True if lhs != rhs
 bool operator>(const Integer& lhs, const Integer& rhs);  // True if lhs > rhs
@@ -92,8 +300,20 @@ Integer operator&(Integer a, const Integer& b); // And: returns result of a&b (b
 Integer operator|(Integer a, const Integer& b); // Or:  returns result of a|b (bitwise)
 Integer operator^(Integer a, const Integer& b); // Xor: returns result of a^b (bitwise)
 
-Integer operator<<(Integer& a, const unsigned int& increment); // Returns a shifted up increment number of times
-Integer operator>>(Integer& a, const unsigned int& increment); // Returns a shifted down increment number of times
+Integer operator<<(Integer a, const unsigned int& increment); // Returns a shifted up increment number of times
+Integer operator>>(Integer a, const unsigned int& increment); // Returns a shifted down increment number of times
+
+
+namespace std {
+
+/** @struct hash
+	@brief Hashes an Integer with hash_value (a word per limb, not a bit at a time).
+*/
+template<>
+struct hash<Integer> {
+	std::size_t operator()(const Integer& a) const { return hash_value(a); }
+};
 
+} // namespace std
 
 #endif //Ends the include guard
\ No newline at end of file
@@ -0,0 +1,254 @@
+/** @file IntegerMatrix.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Bareiss elimination: eliminate() brings a matrix to echelon form one pivot column at a time. Each step multiplies
+the rows below the pivot by the pivot, subtracts the pivot row times their entry in the pivot column (with submul,
+so without a temporary product), and divides exactly by the previous pivot. The pivot of each column is its
+shortest nonzero entry, which keeps the multiplications of the step cheap. Steps with enough cells to update are
+split across ThreadPool::shared() by rows.
+
+solve() eliminates the matrix with b as an extra column, then back-substitutes without fractions: with D the last
+pivot (the determinant, up to sign), y = D * x is a vector of Integers (Cramer's rule), found from the last row up
+by exact division. Each x[i] = y[i] / D is reduced once at the end.
+*/
+
+#include "IntegerMatrix.h"
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include "ThreadPool.h"
+
+namespace {
+
+const std::size_t parallel_cells = 4096; // Steps that update fewer cells run on the calling thread
+
+/** Eliminates the pivot column from rows [first, last)
+	@param a the matrix
+	@param r the pivot row (above first)
+	@param k the pivot column; cells left of it are already zero in the rows below r
+	@param previous the previous pivot (1 for the first step)
+	@param first
+	@param last
+*/
+void update_rows(IntegerMatrix& a, std::size_t r, std::size_t k, const Integer& previous, std::size_t first,
+				 std::size_t last) {
+	const Integer* pivot_row = a.row(r);
+	const Integer& pivot = pivot_row[k];
+	bool divide = (previous != 1);
+	for (std::size_t i = first; i < last; ++i) {
+		Integer* x = a.row(i);
+		Integer factor = std::move(x[k]);
+		x[k] = 0;
+		for (std::size_t j = k + 1; j < a.cols(); ++j) { // x[j] = (x[j] * pivot - factor * pivot_row[j]) / previous
+			x[j] *= pivot;
+			if (factor != 0) {
+				submul(x[j], factor, pivot_row[j]);
+			}
+			if (divide) {
+				x[j] /= previous;
+			}
+		}
+	}
+}
+
+/** One step of Bareiss elimination: updates every row below the pivot row, in parallel if the step is large
+	@param a the matrix
+	@param r the pivot row
+	@param k the pivot column
+	@param previous the previous pivot (1 for the first step)
+*/
+void step(IntegerMatrix& a, std::size_t r, std::size_t k, const Integer& previous) {
+	std::size_t below = a.rows() - r - 1;
+	if (below < 2 || below * (a.cols() - k) < parallel_cells || ThreadPool::shared().size() < 2) {
+		update_rows(a, r, k, previous, r + 1, a.rows());
+		return;
+	}
+	ThreadPool& pool = ThreadPool::shared();
+	std::size_t tasks = std::min(below, pool.size());
+	std::vector<std::future<void>> futures;
+	futures.reserve(tasks);
+	for (std::size_t t = 0; t < tasks; ++t) {
+		std::size_t first = r + 1 + below * t / tasks;
+		std::size_t last = r + 1 + below * (t + 1) / tasks;
+		futures.push_back(pool.submit([&a, r, k, &previous, first, last] {
+			update_rows(a, r, k, previous, first, last);
+		}));
+	}
+	ThreadPool::wait_all(futures);
+}
+
+/** Brings the matrix to echelon form with Bareiss elimination
+	@param a the matrix; on return, row i < rank has its pivot in a column to the right of the pivot of row i - 1,
+	and the cells below each pivot are zero
+	@param cols only the first cols columns are searched for pivots (the rest are updated along with them)
+	@param negated flipped once for each swap of two rows
+	@return the rank of the first cols columns
+*/
+std::size_t eliminate(IntegerMatrix& a, std::size_t cols, bool& negated) {
+	Integer previous = 1;
+	std::size_t r = 0;
+	for (std::size_t k = 0; k < cols && r < a.rows(); ++k) {
+		std::size_t p = a.rows(); // The row of the shortest nonzero entry in column k
+		for (std::size_t i = r; i < a.rows(); ++i) {
+			if (a(i, k) != 0 && (p == a.rows() || a(i, k).bit_length() < a(p, k).bit_length())) {
+				p = i;
+			}
+		}
+		if (p == a.rows()) { // No pivot in this column
+			continue;
+		}
+		if (p != r) {
+			a.swap_rows(p, r);
+			negated = !negated;
+		}
+		step(a, r, k, previous);
+		previous = a(r, k);
+		++r;
+	}
+	return r;
+}
+
+} // namespace
+
+/** Default constructor: an empty matrix
+*/
+IntegerMatrix::IntegerMatrix() : m(0), n(0) {}
+
+/** Constructor: a matrix of zeros
+	@param rows
+	@param cols
+*/
+IntegerMatrix::IntegerMatrix(std::size_t rows, std::size_t cols) : m(rows), n(cols), cells(rows * cols) {}
+
+/** Swaps two rows
+	@param i
+	@param j
+*/
+void IntegerMatrix::swap_rows(std::size_t i, std::size_t j) {
+	std::swap_ranges(row(i), row(i) + n, row(j));
+}
+
+/** Equality: true if lhs and rhs have the same size and the same cells
+	@param lhs
+	@param rhs
+	@return true if lhs == rhs
+*/
+bool operator==(const IntegerMatrix& lhs, const IntegerMatrix& rhs) {
+	if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < lhs.rows(); ++i) {
+		if (!std::equal(lhs.row(i), lhs.row(i) + lhs.cols(), rhs.row(i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Inequality: true if lhs != rhs
+	@param lhs
+	@param rhs
+	@return true if lhs != rhs
+*/
+bool operator!=(const IntegerMatrix& lhs, const IntegerMatrix& rhs) {
+	return !(lhs == rhs);
+}
+
+/** Determinant, by Bareiss elimination (the last pivot is the determinant, up to the sign of the row swaps)
+	@param a a square matrix; throws std::invalid_argument if it is not square
+	@return the determinant (1 for a 0 x 0 matrix)
+*/
+Integer determinant(const IntegerMatrix& a) {
+	if (a.rows() != a.cols()) {
+		throw std::invalid_argument("determinant of a matrix that is not square");
+	}
+	if (a.rows() == 0) {
+		return Integer(1);
+	}
+	IntegerMatrix u = a;
+	bool negated = false;
+	if (eliminate(u, u.cols(), negated) < u.rows()) {
+		return Integer(0);
+	}
+	Integer d = std::move(u(u.rows() - 1, u.cols() - 1));
+	return negated ? -std::move(d) : d;
+}
+
+/** Rank, by Bareiss elimination
+	@param a
+	@return the number of linearly independent rows (or columns)
+*/
+std::size_t rank(const IntegerMatrix& a) {
+	IntegerMatrix u = a;
+	bool negated = false;
+	return eliminate(u, u.cols(), negated);
+}
+
+/** Solves a linear system exactly
+	@param a a square matrix; throws std::domain_error if it is singular
+	@param b the right-hand side, with one entry per row of a (throws std::invalid_argument otherwise)
+	@return the x with a * x == b, each entry reduced
+*/
+std::vector<Fraction<Integer>> solve(const IntegerMatrix& a, const std::vector<Integer>& b) {
+	std::size_t n = a.rows();
+	if (a.cols() != n || b.size() != n) {
+		throw std::invalid_argument("solve needs a square matrix and one right-hand side entry per row");
+	}
+	IntegerMatrix u(n, n + 1); // [a | b]
+	for (std::size_t i = 0; i < n; ++i) {
+		std::copy(a.row(i), a.row(i) + n, u.row(i));
+		u(i, n) = b[i];
+	}
+	bool negated = false;
+	if (eliminate(u, n, negated) < n) {
+		throw std::domain_error("solve with a singular matrix");
+	}
+
+	std::vector<Fraction<Integer>> x(n);
+	if (n == 0) {
+		return x;
+	}
+	const Integer& d = u(n - 1, n - 1);
+	std::vector<Integer> y(n); // d * x
+	for (std::size_t i = n; i-- > 0;) {
+		Integer t = u(i, n);
+		t *= d;
+		for (std::size_t j = i + 1; j < n; ++j) {
+			submul(t, u(i, j), y[j]);
+		}
+		y[i] = t / u(i, i);
+	}
+	for (std::size_t i = 0; i < n; ++i) {
+		x[i] = Fraction<Integer>(std::move(y[i]), d);
+	}
+	return x;
+}
+
+/** Solves a linear system of Fractions exactly, by scaling each equation by the lcm of its denominators
+	@param a the n x n matrix, row by row (throws std::invalid_argument unless it has n * n entries)
+	@param b the right-hand side, with n entries
+	@return the x with a * x == b, each entry reduced (throws std::domain_error if a is singular)
+*/
+std::vector<Fraction<Integer>> solve(const std::vector<Fraction<Integer>>& a, const std::vector<Fraction<Integer>>& b) {
+	std::size_t n = b.size();
+	if (a.size() != n * n) {
+		throw std::invalid_argument("solve needs an n x n matrix for n right-hand side entries");
+	}
+	IntegerMatrix scaled(n, n);
+	std::vector<Integer> rhs(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		Integer l = b[i].denominator();
+		for (std::size_t j = 0; j < n; ++j) {
+			const Integer& q = a[i * n + j].denominator();
+			l *= q / gcd(l, q);
+		}
+		for (std::size_t j = 0; j < n; ++j) {
+			const Fraction<Integer>& f = a[i * n + j];
+			scaled(i, j) = f.numerator() * (l / f.denominator());
+		}
+		rhs[i] = b[i].numerator() * (l / b[i].denominator());
+	}
+	return solve(scaled, rhs);
+}
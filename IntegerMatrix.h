@@ -0,0 +1,68 @@
+/** @file IntegerMatrix.h
+	@brief Contains a matrix of Integers and exact linear algebra on it: determinant, rank and linear solve
+	@author Aviva Prins
+	@date 10/18/2026
+
+	Gaussian elimination on Fraction<Integer> entries reduces (takes a GCD of) every cell it updates. Bareiss'
+	fraction-free elimination works on Integers instead: step k replaces each cell below and to the right of the
+	pivot by
+		a[i][j] = (a[i][j] * a[k][k] - a[i][k] * a[k][j]) / previous pivot,
+	where the division is always exact, and every cell stays a minor of the original matrix (so the entries grow
+	only linearly with the size of the matrix). No GCD is taken until the end: solve() returns the solution as
+	Fractions, each reduced once.
+
+	The rows below the pivot are independent, so each step updates them in parallel on ThreadPool::shared() when the
+	step is large enough (so these functions must not be called from a task running on that pool).
+
+	Matrices are stored row by row in one contiguous array. Usage:
+	IntegerMatrix a(n, n); a(i, j) = ...;
+	Integer d = determinant(a); std::size_t r = rank(a);
+	std::vector<Fraction<Integer>> x = solve(a, b); // a * x == b
+*/
+
+#ifndef INTEGER_MATRIX_H
+#define INTEGER_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+#include "Fraction.h"
+#include "Integer.h"
+
+/** @class IntegerMatrix
+	@brief A rows x cols matrix of Integers, stored row by row in one array.
+*/
+class IntegerMatrix {
+public:
+	// Constructors
+	IntegerMatrix();								// 0 x 0
+	IntegerMatrix(std::size_t rows, std::size_t cols); // Zeros
+
+	// Accessors
+	std::size_t rows() const { return m; }
+	std::size_t cols() const { return n; }
+	Integer& operator()(std::size_t i, std::size_t j) { return cells[i * n + j]; }
+	const Integer& operator()(std::size_t i, std::size_t j) const { return cells[i * n + j]; }
+	Integer* row(std::size_t i) { return cells.data() + i * n; }	// The n cells of row i
+	const Integer* row(std::size_t i) const { return cells.data() + i * n; }
+
+	void swap_rows(std::size_t i, std::size_t j);
+
+private:
+	std::size_t m; // Rows
+	std::size_t n; // Columns
+	std::vector<Integer> cells;
+};
+
+bool operator==(const IntegerMatrix& lhs, const IntegerMatrix& rhs); // True if the sizes and all cells are equal
+bool operator!=(const IntegerMatrix& lhs, const IntegerMatrix& rhs); // True if lhs != rhs
+
+Integer determinant(const IntegerMatrix& a); // The determinant (throws std::invalid_argument if a is not square)
+std::size_t rank(const IntegerMatrix& a);	 // The number of linearly independent rows
+
+// The x with a * x == b (throws std::invalid_argument for mismatched sizes, std::domain_error if a is singular)
+std::vector<Fraction<Integer>> solve(const IntegerMatrix& a, const std::vector<Integer>& b);
+
+// The same for an n x n matrix of Fractions, given row by row (each row is scaled to Integers first)
+std::vector<Fraction<Integer>> solve(const std::vector<Fraction<Integer>>& a, const std::vector<Fraction<Integer>>& b);
+
+#endif //Ends the include guard
@@ -0,0 +1,224 @@
+/** @file InternTable.h
+	@brief Contains a concurrent table that keeps one canonical copy of each distinct value (of Fractions, Integers,
+	or anything with std::hash and ==)
+	@author Aviva Prins
+	@date 10/18/2026
+
+	Datasets of rationals repeat the same values many times. table.intern(x) returns a pointer to the table's copy of
+	x, adding one the first time x is seen, so repeated values share one copy and two interned values are equal
+	exactly when their pointers are. The pointers stay valid until the table is destroyed.
+
+	The table is split into shards by the high bits of the hash, so threads interning different values rarely
+	meet. Each shard is an open-addressing array of atomic pointers to its values:
+	1. lookups do not lock: they follow the pointers, which are only ever published after the value they point to
+	   is complete (release stores, acquire loads), and never change once set;
+	2. adding a value locks the shard's mutex, looks again, and fills an empty slot;
+	3. a shard that is half full is rehashed into an array twice the size, which is then published in place of the
+	   old one. The old array is kept until the table is destroyed, since a lookup may still be reading it (the
+	   arrays of a shard add up to less than twice the size of the last one).
+	A lookup that misses because a value is being added concurrently only costs the lock that intern() then takes.
+
+	Usage: InternTable<Fraction<Integer>> table;
+	       const Fraction<Integer>* p = table.intern(x); // *p == x, and p == table.intern(y) whenever x == y
+	Fractions are stored reduced (hashing reduces them), so their copies can be read from any thread.
+*/
+
+#ifndef INTERN_TABLE_H
+#define INTERN_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Words.h"
+
+/** @class InternTable
+	@brief Maps each distinct value to one stable copy of it, from any number of threads.
+*/
+template<typename T, typename Hash = std::hash<T>>
+class InternTable {
+public:
+	explicit InternTable(std::size_t shards = 64); // Rounded up to a power of two
+
+	InternTable(const InternTable&) = delete;
+	InternTable& operator=(const InternTable&) = delete;
+
+	const T* intern(const T& value); // The table's copy of value (added if value is new)
+	const T* intern(T&& value);		 // The same, moving value in if it is new
+	const T* find(const T& value) const; // The table's copy of value, or null if it has none
+
+	std::size_t size() const; // The number of distinct values
+
+private:
+	struct Node {
+		std::uint64_t hash;
+		T value;
+	};
+
+	struct Slots {
+		explicit Slots(std::size_t n) : mask(n - 1), slot(new std::atomic<const Node*>[n]) {
+			for (std::size_t i = 0; i < n; ++i) {
+				slot[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+		std::size_t mask; // The number of slots (a power of two), minus one
+		std::unique_ptr<std::atomic<const Node*>[]> slot;
+	};
+
+	struct Shard {
+		Shard() : current(nullptr), count(0) {}
+		std::atomic<Slots*> current; // Read without the lock
+		std::atomic<std::size_t> count;
+		std::mutex mutex; // Held to add a value
+		std::vector<std::unique_ptr<Slots>> arrays; // Every array the shard has used (the last is current)
+		std::deque<Node> nodes; // The values (a deque never moves its elements as it grows)
+	};
+
+	std::uint64_t hash_of(const T& value) const;
+	Shard& shard_of(std::uint64_t hash) const { return shards[(hash >> 40) & (count - 1)]; }
+	static const Node* lookup(const Slots& slots, std::uint64_t hash, const T& value);
+	static void place(Slots& slots, const Node* node);
+	template<typename V>
+	const T* add(std::uint64_t hash, V&& value);
+
+	std::size_t count; // The number of shards
+	std::unique_ptr<Shard[]> shards;
+	Hash hasher;
+};
+
+/** Constructor: an empty table
+	@param shards the number of shards (more shards let more threads add values at once)
+*/
+template<typename T, typename Hash>
+InternTable<T, Hash>::InternTable(std::size_t shards) : count(1) {
+	while (count < shards) {
+		count *= 2;
+	}
+	this->shards.reset(new Shard[count]);
+	for (std::size_t i = 0; i < count; ++i) {
+		Shard& s = this->shards[i];
+		s.arrays.emplace_back(new Slots(16));
+		s.current.store(s.arrays.back().get(), std::memory_order_release);
+	}
+}
+
+/** Returns the table's copy of a value, adding one if the value is new
+	@param value
+	@return a pointer to the copy, valid for the life of the table (the same pointer for all equal values)
+*/
+template<typename T, typename Hash>
+const T* InternTable<T, Hash>::intern(const T& value) {
+	std::uint64_t hash = hash_of(value);
+	const Node* node = lookup(*shard_of(hash).current.load(std::memory_order_acquire), hash, value);
+	return node ? &node->value : add(hash, value);
+}
+
+/** Returns the table's copy of a value, moving the value in if it is new
+	@param value
+	@return a pointer to the copy, valid for the life of the table (the same pointer for all equal values)
+*/
+template<typename T, typename Hash>
+const T* InternTable<T, Hash>::intern(T&& value) {
+	std::uint64_t hash = hash_of(value);
+	const Node* node = lookup(*shard_of(hash).current.load(std::memory_order_acquire), hash, value);
+	return node ? &node->value : add(hash, std::move(value));
+}
+
+/** Looks a value up without locking
+	@param value
+	@return a pointer to the table's copy of value, or null if the table has none
+*/
+template<typename T, typename Hash>
+const T* InternTable<T, Hash>::find(const T& value) const {
+	std::uint64_t hash = hash_of(value);
+	const Node* node = lookup(*shard_of(hash).current.load(std::memory_order_acquire), hash, value);
+	return node ? &node->value : nullptr;
+}
+
+/** The number of distinct values
+	@return the number of values added so far
+*/
+template<typename T, typename Hash>
+std::size_t InternTable<T, Hash>::size() const {
+	std::size_t n = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		n += shards[i].count.load(std::memory_order_relaxed);
+	}
+	return n;
+}
+
+/** The hash of a value, mixed again so that the shard and slot bits are spread even for an identity hash
+	(std::hash<int>, for instance)
+	@param value
+	@return the hash
+*/
+template<typename T, typename Hash>
+std::uint64_t InternTable<T, Hash>::hash_of(const T& value) const {
+	return words::hash_mix(std::uint64_t(hasher(value)), words::hash_constants[0]);
+}
+
+/** Finds a value in an array of slots, by linear probing from its hash
+	@param slots
+	@param hash
+	@param value
+	@return the node holding value, or null
+*/
+template<typename T, typename Hash>
+auto InternTable<T, Hash>::lookup(const Slots& slots, std::uint64_t hash, const T& value) -> const Node* {
+	for (std::size_t i = std::size_t(hash) & slots.mask;; i = (i + 1) & slots.mask) {
+		const Node* node = slots.slot[i].load(std::memory_order_acquire);
+		if (!node || (node->hash == hash && node->value == value)) {
+			return node;
+		}
+	}
+}
+
+/** Puts a node in the first empty slot from its hash (the shard's lock is held)
+	@param slots
+	@param node
+*/
+template<typename T, typename Hash>
+void InternTable<T, Hash>::place(Slots& slots, const Node* node) {
+	std::size_t i = std::size_t(node->hash) & slots.mask;
+	while (slots.slot[i].load(std::memory_order_relaxed)) {
+		i = (i + 1) & slots.mask;
+	}
+	slots.slot[i].store(node, std::memory_order_release);
+}
+
+/** Adds a value under its shard's lock, unless another thread added it first
+	@param hash the hash of value
+	@param value
+	@return a pointer to the table's copy of value
+*/
+template<typename T, typename Hash>
+template<typename V>
+const T* InternTable<T, Hash>::add(std::uint64_t hash, V&& value) {
+	Shard& s = shard_of(hash);
+	std::lock_guard<std::mutex> lock(s.mutex);
+	Slots* slots = s.current.load(std::memory_order_relaxed);
+	if (const Node* node = lookup(*slots, hash, value)) {
+		return &node->value;
+	}
+	std::size_t n = s.count.load(std::memory_order_relaxed) + 1;
+	if (2 * n > slots->mask + 1) { // Rehash into an array twice the size, then publish it
+		std::unique_ptr<Slots> larger(new Slots(2 * (slots->mask + 1)));
+		for (const Node& node : s.nodes) {
+			place(*larger, &node);
+		}
+		slots = larger.get();
+		s.arrays.push_back(std::move(larger));
+		s.current.store(slots, std::memory_order_release);
+	}
+	s.nodes.push_back(Node{hash, std::forward<V>(value)});
+	place(*slots, &s.nodes.back());
+	s.count.store(n, std::memory_order_relaxed);
+	return &s.nodes.back().value;
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,621 @@
+/** @file Kernels.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+The innermost limb loops (add_n, sub_n, mul_1, addmul_1, submul_1, cmp_n, the bitwise operations and the lane-wise
+gcd_n), each in a portable version and in versions for newer x86-64 instruction sets:
+1. adx: carry chains with adcx and multiplies with mulx (ADX and BMI2), which do not disturb each other's flags;
+2. avx2: the bitwise operations, comparison and gcd_n four limbs at a time;
+3. avx512: the bitwise operations, comparison and gcd_n eight limbs at a time (AVX-512F, and AVX-512CD for gcd_n).
+
+gcd_n runs binary GCD in every lane at once: each pass shifts the factors of two out of v and replaces (u, v) by
+(min, max - min), and a lane stops changing once its v is zero. Trailing zeros are counted as the population count
+of (x & -x) - 1 with a nibble table in AVX2, and from the leading zero count of x & -x in AVX-512.
+
+The public routines call through a table of function pointers. The table starts out portable (so it is usable from
+any static initializer) and is switched to the best versions this machine supports before main() runs. use_kernels()
+restricts the choice, so that every version can be tested and benchmarked on one machine.
+*/
+
+#include "Limbs.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace limbs {
+
+namespace {
+
+namespace portable {
+
+limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	limb_t carry = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		limb_t x = a[i];
+		limb_t sum = x + b[i];
+		limb_t carry_out = (sum < x);
+		sum += carry;
+		carry_out += (sum < carry);
+		r[i] = sum;
+		carry = carry_out;
+	}
+	return carry;
+}
+
+limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	limb_t borrow = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		limb_t x = a[i];
+		limb_t y = b[i];
+		limb_t diff = x - y;
+		limb_t borrow_out = (x < y);
+		borrow_out += (diff < borrow);
+		r[i] = diff - borrow;
+		borrow = borrow_out;
+	}
+	return borrow;
+}
+
+limb_t mul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	limb_t carry = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		unsigned __int128 t = (unsigned __int128)a[i] * b + carry;
+		r[i] = (limb_t)t;
+		carry = (limb_t)(t >> 64);
+	}
+	return carry;
+}
+
+limb_t addmul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	limb_t carry = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		unsigned __int128 t = (unsigned __int128)a[i] * b + r[i] + carry;
+		r[i] = (limb_t)t;
+		carry = (limb_t)(t >> 64);
+	}
+	return carry;
+}
+
+limb_t submul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	limb_t borrow = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		unsigned __int128 t = (unsigned __int128)a[i] * b + borrow;
+		limb_t low = (limb_t)t;
+		borrow = (limb_t)(t >> 64);
+		limb_t x = r[i];
+		r[i] = x - low;
+		borrow += (x < low);
+	}
+	return borrow;
+}
+
+int cmp_n(const limb_t* a, const limb_t* b, std::size_t n) {
+	while (n-- > 0) { // compares each limb, starting with the most significant
+		if (a[n] != b[n]) {
+			return (a[n] < b[n]) ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+void and_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		r[i] = a[i] & b[i];
+	}
+}
+
+void ior_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		r[i] = a[i] | b[i];
+	}
+}
+
+void xor_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		r[i] = a[i] ^ b[i];
+	}
+}
+
+void com_n(limb_t* r, const limb_t* a, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		r[i] = ~a[i];
+	}
+}
+
+void gcd_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	for (std::size_t i = 0; i < n; ++i) {
+		limb_t u = a[i];
+		limb_t v = b[i];
+		if (u == 0 || v == 0) {
+			r[i] = u | v;
+			continue;
+		}
+		int shift = __builtin_ctzll(u | v);
+		u >>= __builtin_ctzll(u);
+		do { // Written without branches on the data, which would be mispredicted
+			v >>= __builtin_ctzll(v);
+			limb_t low = (u < v) ? u : v;
+			v = (u < v) ? v - u : u - v;
+			u = low;
+		} while (v != 0);
+		r[i] = u << shift;
+	}
+}
+
+} // namespace portable
+
+#if defined(__x86_64__)
+
+namespace adx {
+
+typedef unsigned long long word; // The type the intrinsics take
+
+__attribute__((target("adx"))) limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	unsigned char carry = 0;
+	word sum;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) { // Unrolled so that the carry stays in the flags register
+		carry = _addcarryx_u64(carry, a[i], b[i], &sum);
+		r[i] = sum;
+		carry = _addcarryx_u64(carry, a[i + 1], b[i + 1], &sum);
+		r[i + 1] = sum;
+		carry = _addcarryx_u64(carry, a[i + 2], b[i + 2], &sum);
+		r[i + 2] = sum;
+		carry = _addcarryx_u64(carry, a[i + 3], b[i + 3], &sum);
+		r[i + 3] = sum;
+	}
+	for (; i < n; ++i) {
+		carry = _addcarryx_u64(carry, a[i], b[i], &sum);
+		r[i] = sum;
+	}
+	return carry;
+}
+
+__attribute__((target("adx"))) limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	unsigned char borrow = 0;
+	word diff;
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		borrow = _subborrow_u64(borrow, a[i], b[i], &diff);
+		r[i] = diff;
+		borrow = _subborrow_u64(borrow, a[i + 1], b[i + 1], &diff);
+		r[i + 1] = diff;
+		borrow = _subborrow_u64(borrow, a[i + 2], b[i + 2], &diff);
+		r[i + 2] = diff;
+		borrow = _subborrow_u64(borrow, a[i + 3], b[i + 3], &diff);
+		r[i + 3] = diff;
+	}
+	for (; i < n; ++i) {
+		borrow = _subborrow_u64(borrow, a[i], b[i], &diff);
+		r[i] = diff;
+	}
+	return borrow;
+}
+
+// The multiply-by-a-limb loops keep two carry chains: the high limb of each product is added into the next limb
+// with adcx (which only uses the carry flag), and the result is added into r with adox (which only uses the
+// overflow flag), so neither chain waits for the other. Compilers do not keep two chains in the flags, so these
+// loops are written in assembly; the loop counter is tested with jrcxz, which leaves the flags alone.
+
+__attribute__((target("adx,bmi2"))) limb_t mul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	if (n == 0) {
+		return 0;
+	}
+	word high = 0, low, next;
+	__asm__ volatile(
+		"xor %k[low], %k[low]\n\t" // Clears both flags
+		"1:\n\t"
+		"mulx (%[a]), %[low], %[next]\n\t"
+		"adcx %[high], %[low]\n\t"
+		"mov %[low], (%[r])\n\t"
+		"mov %[next], %[high]\n\t"
+		"lea 8(%[a]), %[a]\n\t"
+		"lea 8(%[r]), %[r]\n\t"
+		"lea -1(%[n]), %[n]\n\t"
+		"jrcxz 2f\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"mov $0, %k[low]\n\t"
+		"adcx %[low], %[high]\n\t"
+		: [a] "+r"(a), [r] "+r"(r), [n] "+c"(n), [high] "+r"(high), [low] "=&r"(low), [next] "=&r"(next)
+		: "d"(b)
+		: "cc", "memory");
+	return high;
+}
+
+__attribute__((target("adx,bmi2"))) limb_t addmul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	if (n == 0) {
+		return 0;
+	}
+	word high = 0, low, next;
+	__asm__ volatile(
+		"xor %k[low], %k[low]\n\t"
+		"1:\n\t"
+		"mulx (%[a]), %[low], %[next]\n\t"
+		"adcx %[high], %[low]\n\t" // Carry chain of the products
+		"adox (%[r]), %[low]\n\t"	 // Carry chain of the sum
+		"mov %[low], (%[r])\n\t"
+		"mov %[next], %[high]\n\t"
+		"lea 8(%[a]), %[a]\n\t"
+		"lea 8(%[r]), %[r]\n\t"
+		"lea -1(%[n]), %[n]\n\t"
+		"jrcxz 2f\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"mov $0, %k[low]\n\t"
+		"adcx %[low], %[high]\n\t"
+		"adox %[low], %[high]\n\t"
+		: [a] "+r"(a), [r] "+r"(r), [n] "+c"(n), [high] "+r"(high), [low] "=&r"(low), [next] "=&r"(next)
+		: "d"(b)
+		: "cc", "memory");
+	return high;
+}
+
+// r - x is computed as ~(~r + x), so that the subtraction is an addition on the overflow flag too
+__attribute__((target("adx,bmi2"))) limb_t submul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	if (n == 0) {
+		return 0;
+	}
+	word high = 0, low, next, x;
+	__asm__ volatile(
+		"xor %k[low], %k[low]\n\t"
+		"1:\n\t"
+		"mulx (%[a]), %[low], %[next]\n\t"
+		"adcx %[high], %[low]\n\t"
+		"mov (%[r]), %[x]\n\t"
+		"not %[x]\n\t"
+		"adox %[low], %[x]\n\t"
+		"not %[x]\n\t"
+		"mov %[x], (%[r])\n\t"
+		"mov %[next], %[high]\n\t"
+		"lea 8(%[a]), %[a]\n\t"
+		"lea 8(%[r]), %[r]\n\t"
+		"lea -1(%[n]), %[n]\n\t"
+		"jrcxz 2f\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"mov $0, %k[low]\n\t"
+		"adcx %[low], %[high]\n\t"
+		"adox %[low], %[high]\n\t"
+		: [a] "+r"(a), [r] "+r"(r), [n] "+c"(n), [high] "+r"(high), [low] "=&r"(low), [next] "=&r"(next),
+		  [x] "=&r"(x)
+		: "d"(b)
+		: "cc", "memory");
+	return high;
+}
+
+} // namespace adx
+
+namespace avx2 {
+
+__attribute__((target("avx2"))) int cmp_n(const limb_t* a, const limb_t* b, std::size_t n) {
+	while (n >= 4) { // Four limbs at a time from the top, until a block differs
+		n -= 4;
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + n));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b + n));
+		int equal = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(x, y)));
+		if (equal != 0xF) {
+			std::size_t i = n + 31 - __builtin_clz(~equal & 0xF); // The highest limb that differs
+			return (a[i] < b[i]) ? -1 : 1;
+		}
+	}
+	return portable::cmp_n(a, b, n);
+}
+
+__attribute__((target("avx2"))) void and_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+		_mm256_storeu_si256((__m256i*)(r + i), _mm256_and_si256(x, y));
+	}
+	portable::and_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2"))) void ior_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+		_mm256_storeu_si256((__m256i*)(r + i), _mm256_or_si256(x, y));
+	}
+	portable::ior_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2"))) void xor_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+		_mm256_storeu_si256((__m256i*)(r + i), _mm256_xor_si256(x, y));
+	}
+	portable::xor_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2"))) void com_n(limb_t* r, const limb_t* a, std::size_t n) {
+	const __m256i ones = _mm256_set1_epi64x(-1);
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+		_mm256_storeu_si256((__m256i*)(r + i), _mm256_xor_si256(x, ones));
+	}
+	portable::com_n(r + i, a + i, n - i);
+}
+
+// Trailing zeros of each lane (64 for a zero lane): the population count of (x & -x) - 1
+__attribute__((target("avx2"))) inline __m256i trailing_zeros(__m256i x) {
+	const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+										   0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i below = _mm256_sub_epi64(_mm256_and_si256(x, _mm256_sub_epi64(zero, x)), _mm256_set1_epi64x(1));
+	__m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(below, nibble));
+	__m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(below, 4), nibble));
+	return _mm256_sad_epu8(_mm256_add_epi8(low, high), zero); // Adds the bytes of each lane
+}
+
+__attribute__((target("avx2"))) void gcd_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	const __m256i zero = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		__m256i u = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i v = _mm256_loadu_si256((const __m256i*)(b + i));
+		u = _mm256_blendv_epi8(u, v, _mm256_cmpeq_epi64(u, zero)); // gcd(0, v) = gcd(v, v)
+		v = _mm256_blendv_epi8(v, u, _mm256_cmpeq_epi64(v, zero));
+		__m256i shift = trailing_zeros(_mm256_or_si256(u, v));
+		u = _mm256_srlv_epi64(u, trailing_zeros(u));
+		__m256i done = _mm256_cmpeq_epi64(v, zero);
+		while (!_mm256_testc_si256(done, _mm256_cmpeq_epi64(zero, zero))) {
+			v = _mm256_srlv_epi64(v, trailing_zeros(v));
+			__m256i greater = _mm256_cmpgt_epi64(u, v); // Signed, which is why the lanes must be below 2^63
+			__m256i low = _mm256_blendv_epi8(u, v, greater);
+			__m256i high = _mm256_blendv_epi8(v, u, greater);
+			u = _mm256_blendv_epi8(low, u, done);
+			v = _mm256_andnot_si256(done, _mm256_sub_epi64(high, low));
+			done = _mm256_cmpeq_epi64(v, zero);
+		}
+		_mm256_storeu_si256((__m256i*)(r + i), _mm256_sllv_epi64(u, shift));
+	}
+	portable::gcd_n(r + i, a + i, b + i, n - i);
+}
+
+} // namespace avx2
+
+namespace avx512 {
+
+__attribute__((target("avx512f"))) int cmp_n(const limb_t* a, const limb_t* b, std::size_t n) {
+	while (n >= 8) {
+		n -= 8;
+		__m512i x = _mm512_loadu_si512((const void*)(a + n));
+		__m512i y = _mm512_loadu_si512((const void*)(b + n));
+		unsigned differ = _mm512_cmpneq_epu64_mask(x, y);
+		if (differ != 0) {
+			std::size_t i = n + 31 - __builtin_clz(differ);
+			return (a[i] < b[i]) ? -1 : 1;
+		}
+	}
+	return portable::cmp_n(a, b, n);
+}
+
+__attribute__((target("avx512f"))) void and_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*)(a + i));
+		__m512i y = _mm512_loadu_si512((const void*)(b + i));
+		_mm512_storeu_si512((void*)(r + i), _mm512_and_si512(x, y));
+	}
+	portable::and_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void ior_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*)(a + i));
+		__m512i y = _mm512_loadu_si512((const void*)(b + i));
+		_mm512_storeu_si512((void*)(r + i), _mm512_or_si512(x, y));
+	}
+	portable::ior_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void xor_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*)(a + i));
+		__m512i y = _mm512_loadu_si512((const void*)(b + i));
+		_mm512_storeu_si512((void*)(r + i), _mm512_xor_si512(x, y));
+	}
+	portable::xor_n(r + i, a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void com_n(limb_t* r, const limb_t* a, std::size_t n) {
+	const __m512i ones = _mm512_set1_epi64(-1);
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i x = _mm512_loadu_si512((const void*)(a + i));
+		_mm512_storeu_si512((void*)(r + i), _mm512_xor_si512(x, ones));
+	}
+	portable::com_n(r + i, a + i, n - i);
+}
+
+// Trailing zeros of each nonzero lane: 63 minus the leading zeros of its lowest set bit
+__attribute__((target("avx512f,avx512cd"))) inline __m512i trailing_zeros(__m512i x) {
+	__m512i lowest = _mm512_and_si512(x, _mm512_sub_epi64(_mm512_setzero_si512(), x));
+	return _mm512_sub_epi64(_mm512_set1_epi64(63), _mm512_lzcnt_epi64(lowest));
+}
+
+__attribute__((target("avx512f,avx512cd"))) void gcd_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		__m512i u = _mm512_loadu_si512((const void*)(a + i));
+		__m512i v = _mm512_loadu_si512((const void*)(b + i));
+		__mmask8 u_zero = _mm512_testn_epi64_mask(u, u);
+		__mmask8 v_zero = _mm512_testn_epi64_mask(v, v);
+		__mmask8 both = ~(u_zero | v_zero); // Lanes where neither is zero (the others are u | v)
+		__m512i shift = trailing_zeros(_mm512_or_si512(u, v));
+		u = _mm512_mask_srlv_epi64(u, both, u, trailing_zeros(u));
+		__mmask8 active = both;
+		while (active) {
+			v = _mm512_mask_srlv_epi64(v, active, v, trailing_zeros(v));
+			__m512i high = _mm512_mask_max_epu64(v, active, u, v);
+			u = _mm512_mask_min_epu64(u, active, u, v);
+			v = _mm512_mask_sub_epi64(v, active, high, u);
+			active = _mm512_mask_test_epi64_mask(active, v, v);
+		}
+		__m512i result = _mm512_mask_sllv_epi64(_mm512_or_si512(u, v), both, u, shift);
+		_mm512_storeu_si512((void*)(r + i), result);
+	}
+	portable::gcd_n(r + i, a + i, b + i, n - i);
+}
+
+} // namespace avx512
+
+#endif // defined(__x86_64__)
+
+/** @class Table
+	@brief The version of each kernel in use.
+*/
+struct Table {
+	limb_t (*add_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+	limb_t (*sub_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+	limb_t (*mul_1)(limb_t*, const limb_t*, std::size_t, limb_t);
+	limb_t (*addmul_1)(limb_t*, const limb_t*, std::size_t, limb_t);
+	limb_t (*submul_1)(limb_t*, const limb_t*, std::size_t, limb_t);
+	int (*cmp_n)(const limb_t*, const limb_t*, std::size_t);
+	void (*and_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+	void (*ior_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+	void (*xor_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+	void (*com_n)(limb_t*, const limb_t*, std::size_t);
+	void (*gcd_n)(limb_t*, const limb_t*, const limb_t*, std::size_t);
+};
+
+// Constant-initialized, so it is valid before any dynamic initialization
+Table table = {portable::add_n, portable::sub_n, portable::mul_1, portable::addmul_1, portable::submul_1,
+			   portable::cmp_n, portable::and_n, portable::ior_n, portable::xor_n, portable::com_n, portable::gcd_n};
+Isa ceiling = Isa::portable;
+
+/** Fills the table with the best versions that need no more than isa and run on this machine
+*/
+void select(Isa isa) {
+	table = {portable::add_n, portable::sub_n, portable::mul_1, portable::addmul_1, portable::submul_1,
+			 portable::cmp_n, portable::and_n, portable::ior_n, portable::xor_n, portable::com_n, portable::gcd_n};
+#if defined(__x86_64__)
+	if (isa >= Isa::adx && host_supports(Isa::adx)) {
+		table.add_n = adx::add_n;
+		table.sub_n = adx::sub_n;
+		table.mul_1 = adx::mul_1;
+		table.addmul_1 = adx::addmul_1;
+		table.submul_1 = adx::submul_1;
+	}
+	if (isa >= Isa::avx512 && host_supports(Isa::avx512)) {
+		table.cmp_n = avx512::cmp_n;
+		table.and_n = avx512::and_n;
+		table.ior_n = avx512::ior_n;
+		table.xor_n = avx512::xor_n;
+		table.com_n = avx512::com_n;
+		table.gcd_n = __builtin_cpu_supports("avx512cd") ? avx512::gcd_n : avx2::gcd_n; // Every AVX-512 CPU has AVX2
+	}
+	else if (isa >= Isa::avx2 && host_supports(Isa::avx2)) {
+		table.cmp_n = avx2::cmp_n;
+		table.and_n = avx2::and_n;
+		table.ior_n = avx2::ior_n;
+		table.xor_n = avx2::xor_n;
+		table.com_n = avx2::com_n;
+		table.gcd_n = avx2::gcd_n;
+	}
+#endif
+	ceiling = isa;
+}
+
+const bool selected_at_startup = (select(Isa::avx512), true);
+
+} // namespace
+
+/** Checks whether this machine (and its operating system) supports an instruction set
+	@param isa
+	@return true if the kernels for isa can run here
+*/
+bool host_supports(Isa isa) {
+#if defined(__x86_64__)
+	__builtin_cpu_init(); // Needed when called from a static initializer
+	switch (isa) {
+	case Isa::portable:
+		return true;
+	case Isa::adx:
+		return __builtin_cpu_supports("adx") && __builtin_cpu_supports("bmi2");
+	case Isa::avx2:
+		return __builtin_cpu_supports("avx2");
+	case Isa::avx512:
+		return __builtin_cpu_supports("avx512f");
+	}
+	return false;
+#else
+	return isa == Isa::portable;
+#endif
+}
+
+/** Restricts the kernels to an instruction set: each kernel uses its best version that needs no more than isa and
+	runs on this machine. Not thread-safe: call it before other threads use the limb routines.
+	@param isa the newest instruction set to use; Isa::portable forces the portable versions
+	@return false (changing nothing) if this machine does not support isa
+*/
+bool use_kernels(Isa isa) {
+	if (!host_supports(isa)) {
+		return false;
+	}
+	select(isa);
+	return true;
+}
+
+/** Returns the instruction set that the kernels are restricted to (Isa::avx512, the newest, unless use_kernels()
+	was called)
+*/
+Isa kernel_isa() {
+	return ceiling;
+}
+
+limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	return table.add_n(r, a, b, n);
+}
+
+limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	return table.sub_n(r, a, b, n);
+}
+
+limb_t mul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	return table.mul_1(r, a, n, b);
+}
+
+limb_t addmul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	return table.addmul_1(r, a, n, b);
+}
+
+limb_t submul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	return table.submul_1(r, a, n, b);
+}
+
+int cmp_n(const limb_t* a, const limb_t* b, std::size_t n) {
+	return table.cmp_n(a, b, n);
+}
+
+void and_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	table.and_n(r, a, b, n);
+}
+
+void ior_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	table.ior_n(r, a, b, n);
+}
+
+void xor_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	table.xor_n(r, a, b, n);
+}
+
+void com_n(limb_t* r, const limb_t* a, std::size_t n) {
+	table.com_n(r, a, n);
+}
+
+void gcd_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	table.gcd_n(r, a, b, n);
+}
+
+} // namespace limbs
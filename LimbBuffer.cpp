@@ -0,0 +1,159 @@
+/** @file LimbBuffer.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Storage for the limbs of an Integer: up to LimbBuffer::inline_capacity limbs live inside the object, and larger
+values move to a heap block. Heap allocations are counted in LimbBuffer::allocations().
+*/
+
+#include "LimbBuffer.h"
+#include <algorithm>
+
+std::atomic<std::size_t> LimbBuffer::allocation_count(0);
+
+/** Default constructor: an empty buffer using the inline storage
+*/
+LimbBuffer::LimbBuffer() : ptr(local), count(0), cap(inline_capacity) {}
+
+/** Constructor: n limbs with the same value
+	@param n the size; only allocates if n > inline_capacity
+	@param value the value of every limb
+*/
+LimbBuffer::LimbBuffer(std::size_t n, limb_t value) : ptr(local), count(0), cap(inline_capacity) {
+	resize(n, value);
+}
+
+/** Constructor: a copy of a range of limbs
+	@param first
+	@param last
+*/
+LimbBuffer::LimbBuffer(const limb_t* first, const limb_t* last) : ptr(local), count(0), cap(inline_capacity) {
+	assign(first, last);
+}
+
+/** Copy constructor
+	@param other the buffer being copied; only allocates if other does not fit inline
+*/
+LimbBuffer::LimbBuffer(const LimbBuffer& other) : ptr(local), count(0), cap(inline_capacity) {
+	reserve(other.count);
+	std::copy(other.ptr, other.ptr + other.count, ptr);
+	count = other.count;
+}
+
+/** Move constructor
+	@param other the buffer being moved; a heap block is taken over, inline limbs are copied
+*/
+LimbBuffer::LimbBuffer(LimbBuffer&& other) noexcept : ptr(local), count(other.count), cap(inline_capacity) {
+	if (other.is_inline()) {
+		std::copy(other.local, other.local + other.count, local);
+	}
+	else {
+		ptr = other.ptr;
+		cap = other.cap;
+		other.ptr = other.local;
+		other.cap = inline_capacity;
+	}
+	other.count = 0;
+}
+
+/** Destructor: releases the heap block (if there is one)
+*/
+LimbBuffer::~LimbBuffer() {
+	if (!is_inline()) {
+		delete[] ptr;
+	}
+}
+
+/** Copy assignment: reuses the existing storage when it is large enough
+	@param other the buffer being copied
+	@return reference to lhs
+*/
+LimbBuffer& LimbBuffer::operator=(const LimbBuffer& other) {
+	if (this != &other) {
+		reserve(other.count);
+		std::copy(other.ptr, other.ptr + other.count, ptr);
+		count = other.count;
+	}
+	return (*this);
+}
+
+/** Move assignment
+	@param other the buffer being moved
+	@return reference to lhs
+*/
+LimbBuffer& LimbBuffer::operator=(LimbBuffer&& other) noexcept {
+	if (this != &other) {
+		if (other.is_inline()) { // Nothing to take over; copy the (at most inline_capacity) limbs
+			std::copy(other.local, other.local + other.count, ptr);
+			count = other.count;
+		}
+		else { // Take over the heap block of other, releasing our own
+			if (!is_inline()) {
+				delete[] ptr;
+			}
+			ptr = other.ptr;
+			count = other.count;
+			cap = other.cap;
+			other.ptr = other.local;
+			other.cap = inline_capacity;
+		}
+		other.count = 0;
+	}
+	return (*this);
+}
+
+/** Exchanges the contents of two buffers
+	@param other the buffer being exchanged with lhs
+*/
+void LimbBuffer::swap(LimbBuffer& other) noexcept {
+	if (is_inline() || other.is_inline()) { // Inline limbs have to be copied across
+		LimbBuffer temp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(temp);
+		return;
+	}
+	std::swap(ptr, other.ptr);
+	std::swap(count, other.count);
+	std::swap(cap, other.cap);
+}
+
+/** Moves the limbs to a heap block with room for at least n limbs
+	@param n the number of limbs needed
+*/
+void LimbBuffer::grow(std::size_t n) {
+	std::size_t new_cap = std::max<std::size_t>(n, 2 * static_cast<std::size_t>(cap));
+	limb_t* block = new limb_t[new_cap];
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	std::copy(ptr, ptr + count, block);
+	if (!is_inline()) {
+		delete[] ptr;
+	}
+	ptr = block;
+	cap = static_cast<std::uint32_t>(new_cap);
+}
+
+/** Returns the number of heap allocations made by all LimbBuffers so far
+	@return the running allocation count
+*/
+std::size_t LimbBuffer::allocations() {
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+/** Returns true if both buffers hold the same limbs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs == rhs
+*/
+bool operator==(const LimbBuffer& lhs, const LimbBuffer& rhs) {
+	return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+/** Returns true if the buffers hold different limbs (otherwise, false)
+	@param lhs
+	@param rhs
+	@return true if lhs != rhs
+*/
+bool operator!=(const LimbBuffer& lhs, const LimbBuffer& rhs) {
+	return !(lhs == rhs);
+}
\ No newline at end of file
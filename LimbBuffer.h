@@ -0,0 +1,146 @@
+/** @file LimbBuffer.h
+	@brief Contains the class declaration for the limb storage used by Integer
+	@author Aviva Prins
+	@date 10/18/2026
+
+	A LimbBuffer behaves like a std::vector of 64-bit words, except that values of up to two words are kept inside
+	the object itself. Only values that grow past two words spill to the heap. Arithmetic on Integers of up to two
+	limbs (including division by a divisor of one or two limbs, and gcd) therefore makes no allocation, except for a
+	result that needs more than two limbs.
+
+	Every heap allocation made by any LimbBuffer is counted; LimbBuffer::allocations() returns the running total so
+	that callers can check how many allocations a piece of code makes. The library keeps all of its limb arrays in
+	LimbBuffers, including the scratch space of multiplication (Karatsuba, Toom-3, the transforms), division and
+	radix conversion, so the count covers every limb array it allocates. It does not cover other heap blocks: the
+	strings of decimal text, the containers that callers keep their values in, and the bookkeeping of the cache of
+	powers of ten in Radix.cpp (whose limbs are counted the first time each power is made).
+*/
+
+#ifndef LIMB_BUFFER_H
+#define LIMB_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/** @class LimbBuffer
+	@brief A vector of 64-bit limbs with inline storage for small values.
+
+Supports the subset of the std::vector interface that Integer uses. The inline buffer holds inline_capacity limbs;
+growing past that moves the limbs to a heap block, which is kept (and reused) until the buffer is destroyed.
+
+*/
+class LimbBuffer {
+public:
+	typedef std::uint64_t limb_t;
+	static const std::size_t inline_capacity = 2; // Number of limbs stored without allocating
+
+	// Constructors
+	LimbBuffer();								// Empty buffer using the inline storage
+	explicit LimbBuffer(std::size_t n, limb_t value = 0); // n limbs set to value
+	LimbBuffer(const limb_t* first, const limb_t* last);  // Copies the limbs [first, last)
+	LimbBuffer(const LimbBuffer& other);		// Copies the limbs of other
+	LimbBuffer(LimbBuffer&& other) noexcept;	// Takes over the heap block of other (if it has one)
+	~LimbBuffer();
+
+	LimbBuffer& operator=(const LimbBuffer& other);
+	LimbBuffer& operator=(LimbBuffer&& other) noexcept;
+
+	// Accessors
+	std::size_t size() const { return count; }
+	std::size_t capacity() const { return cap; }
+	bool empty() const { return count == 0; }
+	bool is_inline() const { return ptr == local; } // True if the limbs are stored inside the object
+
+	limb_t* data() { return ptr; }
+	const limb_t* data() const { return ptr; }
+	limb_t& operator[](std::size_t i) { return ptr[i]; }
+	const limb_t& operator[](std::size_t i) const { return ptr[i]; }
+	limb_t& back() { return ptr[count - 1]; }
+	const limb_t& back() const { return ptr[count - 1]; }
+
+	limb_t* begin() { return ptr; }
+	limb_t* end() { return ptr + count; }
+	const limb_t* begin() const { return ptr; }
+	const limb_t* end() const { return ptr + count; }
+
+	// Mutators
+	void reserve(std::size_t n);					// Makes room for n limbs without changing the size
+	void resize(std::size_t n, limb_t value = 0);	// New limbs (if any) are set to value
+	void assign(std::size_t n, limb_t value);		// n limbs set to value (keeps the capacity)
+	void assign(const limb_t* first, const limb_t* last); // Copies the limbs [first, last) (keeps the capacity)
+	void push_back(limb_t value);
+	void pop_back() { --count; }
+	void clear() { count = 0; }					// Keeps the capacity
+	void swap(LimbBuffer& other) noexcept;
+
+	static std::size_t allocations(); // Total number of heap allocations made by LimbBuffers so far
+
+private:
+	void grow(std::size_t n); // Moves the limbs to a heap block with room for at least n limbs
+
+	limb_t* ptr;		 // Points at local or at a heap block
+	std::uint32_t count; // Number of limbs in use
+	std::uint32_t cap;	 // Number of limbs available at ptr
+	limb_t local[inline_capacity];
+
+	static std::atomic<std::size_t> allocation_count;
+};
+
+bool operator==(const LimbBuffer& lhs, const LimbBuffer& rhs); // True if both hold the same limbs
+bool operator!=(const LimbBuffer& lhs, const LimbBuffer& rhs); // True if the limbs differ
+
+/** Makes room for n limbs without changing the size
+	@param n the number of limbs needed
+*/
+inline void LimbBuffer::reserve(std::size_t n) {
+	if (n > cap) {
+		grow(n);
+	}
+}
+
+/** Changes the number of limbs in use
+	@param n the new size
+	@param value the value given to new limbs
+*/
+inline void LimbBuffer::resize(std::size_t n, limb_t value) {
+	reserve(n);
+	for (std::size_t i = count; i < n; ++i) {
+		ptr[i] = value;
+	}
+	count = static_cast<std::uint32_t>(n);
+}
+
+/** Replaces the limbs with n copies of a value
+	@param n the new size
+	@param value
+*/
+inline void LimbBuffer::assign(std::size_t n, limb_t value) {
+	clear();
+	resize(n, value);
+}
+
+/** Replaces the limbs with a copy of a range (which must not be inside this buffer)
+	@param first
+	@param last
+*/
+inline void LimbBuffer::assign(const limb_t* first, const limb_t* last) {
+	std::size_t n = static_cast<std::size_t>(last - first);
+	reserve(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		ptr[i] = first[i];
+	}
+	count = static_cast<std::uint32_t>(n);
+}
+
+/** Appends a limb
+	@param value the new most significant limb
+*/
+inline void LimbBuffer::push_back(limb_t value) {
+	if (count == cap) {
+		grow(2 * static_cast<std::size_t>(cap));
+	}
+	ptr[count++] = value;
+}
+
+#endif //Ends the include guard
\ No newline at end of file
@@ -0,0 +1,479 @@
+/** @file Limbs.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Low-level arithmetic on arrays of 64-bit limbs (least significant limb first). See Limbs.h for the conventions
+shared by all of the routines. The innermost loops, which have versions for several instruction sets, are in
+Kernels.cpp.
+*/
+
+#include "LimbBuffer.h"
+#include "Limbs.h"
+#include <algorithm>
+
+namespace limbs {
+
+Thresholds thresholds;
+
+/** Adds a shorter array to a longer one
+	@param r receives a + b (n limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs, m <= n)
+	@return the carry out of the most significant limb
+*/
+limb_t add(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	limb_t carry = add_n(r, a, b, m);
+	return add_1(r + m, a + m, n - m, carry);
+}
+
+/** Adds a single limb to an array
+	@param r receives a + b (n limbs)
+	@param a first operand (n limbs)
+	@param b the limb being added
+	@return the carry out of the most significant limb
+*/
+limb_t add_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	std::size_t i = 0;
+	for (; i < n && b != 0; ++i) { // Propagate the carry only as far as it goes
+		limb_t sum = a[i] + b;
+		b = (sum < b);
+		r[i] = sum;
+	}
+	if (r != a) { // The rest of a is copied unchanged
+		for (; i < n; ++i) {
+			r[i] = a[i];
+		}
+	}
+	return b;
+}
+
+/** Subtracts a shorter array from a longer one
+	@param r receives a - b (n limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs, m <= n)
+	@return the borrow out of the most significant limb
+*/
+limb_t sub(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	limb_t borrow = sub_n(r, a, b, m);
+	return sub_1(r + m, a + m, n - m, borrow);
+}
+
+/** Subtracts a single limb from an array
+	@param r receives a - b (n limbs)
+	@param a first operand (n limbs)
+	@param b the limb being subtracted
+	@return the borrow out of the most significant limb
+*/
+limb_t sub_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b) {
+	std::size_t i = 0;
+	for (; i < n && b != 0; ++i) { // Propagate the borrow only as far as it goes
+		limb_t x = a[i];
+		r[i] = x - b;
+		b = (x < b);
+	}
+	if (r != a) { // The rest of a is copied unchanged
+		for (; i < n; ++i) {
+			r[i] = a[i];
+		}
+	}
+	return b;
+}
+
+/** Compares two arrays of any length
+	@param a first operand (n limbs)
+	@param b second operand (m limbs)
+	@return -1 if a < b, 0 if a == b, 1 if a > b
+*/
+int cmp(const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	n = normalized_size(a, n);
+	m = normalized_size(b, m);
+	if (n != m) {
+		return (n < m) ? -1 : 1;
+	}
+	return cmp_n(a, b, n);
+}
+
+/** Finds the length of an array without its leading zero limbs
+	@param a the array
+	@param n length of a
+	@return the number of limbs up to and including the most significant nonzero limb
+*/
+std::size_t normalized_size(const limb_t* a, std::size_t n) {
+	while (n > 0 && a[n - 1] == 0) {
+		--n;
+	}
+	return n;
+}
+
+/** Shifts an array up by less than one limb (a funnel shift of each pair of neighbouring limbs)
+	@param r receives the low n limbs of a * 2^bits; may be a, or start above a
+	@param a the array (n limbs, n >= 1)
+	@param bits the shift amount (0 < bits < 64)
+	@return the bits shifted out of the most significant limb
+*/
+limb_t lshift(limb_t* r, const limb_t* a, std::size_t n, unsigned bits) {
+	limb_t out = a[n - 1] >> (64 - bits);
+	for (std::size_t i = n - 1; i > 0; --i) { // Top down, so that r may overlap a from above
+		r[i] = (a[i] << bits) | (a[i - 1] >> (64 - bits));
+	}
+	r[0] = a[0] << bits;
+	return out;
+}
+
+/** Shifts an array down by less than one limb
+	@param r receives a / 2^bits (n limbs); may be a, or start below a
+	@param a the array (n limbs, n >= 1)
+	@param bits the shift amount (0 < bits < 64)
+	@return the bits shifted out of the least significant limb, in the top of the returned limb
+*/
+limb_t rshift(limb_t* r, const limb_t* a, std::size_t n, unsigned bits) {
+	limb_t out = a[0] << (64 - bits);
+	for (std::size_t i = 0; i + 1 < n; ++i) { // Bottom up, so that r may overlap a from below
+		r[i] = (a[i] >> bits) | (a[i + 1] << (64 - bits));
+	}
+	r[n - 1] = a[n - 1] >> bits;
+	return out;
+}
+
+/** Schoolbook multiplication: one multiply-and-add pass over a for every limb of b
+	@param r receives a * b (n + m limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs, m >= 1)
+*/
+void mul_basecase(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	r[n] = mul_1(r, a, n, b[0]);
+	for (std::size_t j = 1; j < m; ++j) {
+		r[n + j] = addmul_1(r + j, a, n, b[j]);
+	}
+}
+
+namespace {
+
+/** Computes the absolute difference of two arrays
+	@param r receives |a - b| (max(n, m) limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs)
+	@return true if a < b
+*/
+bool abs_sub(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	bool negative = cmp(a, n, b, m) < 0;
+	if (negative) {
+		std::swap(a, b);
+		std::swap(n, m);
+	}
+	std::size_t size = std::max(n, m);
+	m = std::min(normalized_size(b, m), n); // b <= a, so its significant limbs fit in n
+	sub(r, a, n, b, m);
+	std::fill(r + n, r + size, 0);
+	return negative;
+}
+
+/** Returns the number of scratch limbs that karatsuba() needs for operands of n limbs
+	@param n length of the operands
+*/
+std::size_t karatsuba_scratch(std::size_t n) {
+	if (n < thresholds.mul_karatsuba || n >= thresholds.mul_toom3) { // Not handled by karatsuba()
+		return 0;
+	}
+	std::size_t hn = n - n / 2;
+	return 6 * hn + 1 + karatsuba_scratch(hn);
+}
+
+/** Karatsuba multiplication: three half-size products instead of four
+	@param r receives a * b (2n limbs)
+	@param a first operand (n limbs)
+	@param b second operand (n limbs)
+	@param n length of the operands
+	@param scratch karatsuba_scratch(n) limbs of working space
+
+	Splits a = a1*B^h + a0 and b = b1*B^h + b0, and uses the identity
+	a*b = a1*b1*B^2h + (a0*b0 + a1*b1 - (a0 - a1)*(b0 - b1))*B^h + a0*b0.
+*/
+void karatsuba(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n, limb_t* scratch) {
+	if (n < thresholds.mul_karatsuba) {
+		mul_basecase(r, a, n, b, n);
+		return;
+	}
+	std::size_t h = n / 2;	 // Length of the low halves
+	std::size_t hn = n - h; // Length of the high halves (h or h + 1)
+
+	limb_t* da = scratch;			 // |a0 - a1|, hn limbs
+	limb_t* db = da + hn;			 // |b0 - b1|, hn limbs
+	limb_t* mid = db + hn;			 // da * db, 2hn limbs
+	limb_t* t = mid + 2 * hn;		 // a0*b0 + a1*b1 -/+ mid, 2hn + 1 limbs
+	limb_t* next = t + 2 * hn + 1; // Scratch for the recursive calls
+
+	bool negative = abs_sub(da, a, h, a + h, hn);
+	negative ^= abs_sub(db, b, h, b + h, hn);
+
+	karatsuba(r, a, b, h, next);					 // a0*b0 in the low 2h limbs
+	karatsuba(r + 2 * h, a + h, b + h, hn, next); // a1*b1 in the high 2hn limbs
+	karatsuba(mid, da, db, hn, next);
+
+	t[2 * hn] = add(t, r + 2 * h, 2 * hn, r, 2 * h);
+	if (negative) { // (a0 - a1)*(b0 - b1) < 0, so the middle term grows
+		add(t, t, 2 * hn + 1, mid, 2 * hn);
+	}
+	else {
+		sub(t, t, 2 * hn + 1, mid, 2 * hn);
+	}
+	add(r + h, r + h, 2 * n - h, t, normalized_size(t, 2 * hn + 1));
+}
+
+/** A signed number used for the intermediate values of Toom-3 (the final coefficients are never negative) */
+struct SignedLimbs {
+	LimbBuffer mag;
+	bool neg = false;
+
+	std::size_t size() const { return mag.size(); }
+	void trim() {
+		mag.resize(normalized_size(mag.data(), mag.size()));
+		if (mag.empty()) {
+			neg = false;
+		}
+	}
+};
+
+/** Sets r = a + b, or r = a - b if subtract is true
+	@param r receives the result (may be a or b)
+	@param a
+	@param b
+	@param subtract flips the sign of b
+*/
+void signed_add(SignedLimbs& r, const SignedLimbs& a, const SignedLimbs& b, bool subtract) {
+	bool b_neg = b.neg != subtract;
+	std::size_t size = std::max(a.size(), b.size()) + 1;
+	LimbBuffer result(size, 0);
+	bool neg = a.neg;
+	if (a.neg == b_neg) {
+		const SignedLimbs& x = (a.size() >= b.size()) ? a : b;
+		const SignedLimbs& y = (a.size() >= b.size()) ? b : a;
+		result[x.size()] = add(result.data(), x.mag.data(), x.size(), y.mag.data(), y.size());
+	}
+	else {
+		bool a_smaller = abs_sub(result.data(), a.mag.data(), a.size(), b.mag.data(), b.size());
+		neg = a_smaller ? b_neg : a.neg;
+	}
+	r.mag.swap(result);
+	r.neg = neg;
+	r.trim();
+}
+
+/** Divides r by 2^bits (exactly) or multiplies r by 2^bits
+	@param r the value being shifted
+	@param bits the shift amount (0 < bits < 64)
+	@param left shifts up if true, down if false
+*/
+void signed_shift(SignedLimbs& r, unsigned bits, bool left) {
+	if (r.mag.empty()) {
+		return;
+	}
+	if (left) {
+		limb_t carry = lshift(r.mag.data(), r.mag.data(), r.size(), bits);
+		if (carry) {
+			r.mag.push_back(carry);
+		}
+	}
+	else {
+		rshift(r.mag.data(), r.mag.data(), r.size(), bits);
+		r.trim();
+	}
+}
+
+/** Divides r by 3, which must divide r exactly
+	@param r the value being divided
+
+	Multiplies by the inverse of 3 modulo 2^64, limb by limb, so there is no division instruction.
+*/
+void signed_divexact_3(SignedLimbs& r) {
+	const limb_t inverse = 0xAAAAAAAAAAAAAAABull; // 3 * inverse == 1 (mod 2^64)
+	limb_t carry = 0;
+	for (limb_t& x : r.mag) {
+		limb_t borrow = (x < carry);
+		limb_t q = (x - carry) * inverse;
+		x = q;
+		carry = (limb_t)(((unsigned __int128)q * 3) >> 64) + borrow;
+	}
+	r.trim();
+}
+
+/** Multiplies two signed values
+	@param r receives a * b
+	@param a
+	@param b
+*/
+void signed_mul(SignedLimbs& r, const SignedLimbs& a, const SignedLimbs& b) {
+	r.mag.assign(a.size() + b.size(), 0);
+	r.neg = a.neg != b.neg;
+	if (a.size() != 0 && b.size() != 0) {
+		mul(r.mag.data(), a.mag.data(), a.size(), b.mag.data(), b.size());
+	}
+	r.trim();
+}
+
+/** Makes a SignedLimbs from part of an array
+	@param a the array
+	@param n length of the part
+*/
+SignedLimbs signed_from(const limb_t* a, std::size_t n) {
+	SignedLimbs r;
+	r.mag.assign(a, a + n);
+	r.trim();
+	return r;
+}
+
+/** Toom-3 multiplication: five third-size products instead of nine
+	@param r receives a * b (2n limbs)
+	@param a first operand (n limbs)
+	@param b second operand (n limbs)
+	@param n length of the operands
+
+	Splits each operand into three pieces of k limbs, evaluates the pieces as polynomials at 0, 1, -1, -2 and infinity,
+	multiplies pointwise, and interpolates the five coefficients of the product with Bodrato's sequence.
+*/
+void toom3(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	std::size_t k = (n + 2) / 3;
+	SignedLimbs a0 = signed_from(a, k), a1 = signed_from(a + k, k), a2 = signed_from(a + 2 * k, n - 2 * k);
+	SignedLimbs b0 = signed_from(b, k), b1 = signed_from(b + k, k), b2 = signed_from(b + 2 * k, n - 2 * k);
+
+	// Evaluation: p(1) = a0 + a1 + a2, p(-1) = a0 - a1 + a2, p(-2) = a0 - 2*a1 + 4*a2
+	SignedLimbs pa, pb, p1, q1, pm1, qm1, pm2, qm2;
+	signed_add(pa, a0, a2, false);
+	signed_add(p1, pa, a1, false);
+	signed_add(pm1, pa, a1, true);
+	signed_add(pm2, pm1, a2, false); // a0 - a1 + 2*a2
+	signed_shift(pm2, 1, true);
+	signed_add(pm2, pm2, a0, true); // a0 - 2*a1 + 4*a2
+
+	signed_add(pb, b0, b2, false);
+	signed_add(q1, pb, b1, false);
+	signed_add(qm1, pb, b1, true);
+	signed_add(qm2, qm1, b2, false);
+	signed_shift(qm2, 1, true);
+	signed_add(qm2, qm2, b0, true);
+
+	// Pointwise products
+	SignedLimbs w0, w1, wm1, wm2, winf;
+	signed_mul(w0, a0, b0);
+	signed_mul(w1, p1, q1);
+	signed_mul(wm1, pm1, qm1);
+	signed_mul(wm2, pm2, qm2);
+	signed_mul(winf, a2, b2);
+
+	// Interpolation (Bodrato): the product is r0 + r1*x + r2*x^2 + r3*x^3 + r4*x^4 at x = B^k
+	SignedLimbs r1, r2, r3;
+	signed_add(r3, wm2, w1, true);
+	signed_divexact_3(r3);				// (w(-2) - w1) / 3
+	signed_add(r1, w1, wm1, true);
+	signed_shift(r1, 1, false);			// (w1 - w(-1)) / 2
+	signed_add(r2, wm1, w0, true);		// w(-1) - w0
+	signed_add(r3, r2, r3, true);
+	signed_shift(r3, 1, false);
+	signed_add(r3, r3, winf, false);
+	signed_add(r3, r3, winf, false);	// (r2 - r3) / 2 + 2*winf
+	signed_add(r2, r2, r1, false);
+	signed_add(r2, r2, winf, true);		// r2 + r1 - winf
+	signed_add(r1, r1, r3, true);		// r1 - r3
+
+	// Recomposition
+	std::fill(r, r + 2 * n, 0);
+	const SignedLimbs* coefficients[5] = { &w0, &r1, &r2, &r3, &winf };
+	for (std::size_t i = 0; i < 5; ++i) {
+		const SignedLimbs& c = *coefficients[i];
+		std::size_t offset = i * k;
+		if (c.size() != 0) {
+			add(r + offset, r + offset, 2 * n - offset, c.mag.data(), std::min(c.size(), 2 * n - offset));
+		}
+	}
+}
+
+} // namespace
+
+/** Multiplies two arrays of the same length, choosing the algorithm from the length
+	@param r receives a * b (2n limbs)
+	@param a first operand (n limbs)
+	@param b second operand (n limbs)
+	@param n length of the operands
+*/
+void mul_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n) {
+	if (n < thresholds.mul_karatsuba) {
+		if (n > 0) {
+			mul_basecase(r, a, n, b, n);
+		}
+	}
+	else if (n < thresholds.mul_toom3) {
+		LimbBuffer scratch(karatsuba_scratch(n));
+		karatsuba(r, a, b, n, scratch.data());
+	}
+	else if (n < thresholds.mul_fft) {
+		toom3(r, a, b, n);
+	}
+	else {
+		mul_fft(r, a, n, b, n);
+	}
+}
+
+/** Squares an array, choosing the algorithm from the length
+	@param r receives a * a (2n limbs)
+	@param a the operand (n limbs)
+	@param n length of the operand
+*/
+void sqr(limb_t* r, const limb_t* a, std::size_t n) {
+	if (n >= thresholds.mul_fft) {
+		sqr_fft(r, a, n);
+	}
+	else {
+		mul_n(r, a, a, n);
+	}
+}
+
+/** Multiplies two arrays of any lengths
+	@param r receives a * b (n + m limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs)
+
+	Short operands use schoolbook multiplication directly. Operands of similar length are multiplied as a balanced
+	product (the shorter one padded with zeros). When a is much longer than b, a is split into pieces of m limbs,
+	and each piece times b is a balanced product that is added into place.
+*/
+void mul(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	if (n < m) {
+		std::swap(a, b);
+		std::swap(n, m);
+	}
+	if (m == 0) {
+		std::fill(r, r + n, 0);
+		return;
+	}
+	if (m < thresholds.mul_karatsuba) {
+		mul_basecase(r, a, n, b, m);
+		return;
+	}
+	if (n == m) {
+		mul_n(r, a, b, n);
+		return;
+	}
+	if (m >= thresholds.mul_fft) { // The transforms handle any pair of lengths directly
+		mul_fft(r, a, n, b, m);
+		return;
+	}
+	if (2 * n <= 3 * m) { // Nearly balanced: pad b to the length of a
+		LimbBuffer padded(b, b + m);
+		padded.resize(n, 0);
+		LimbBuffer product(2 * n);
+		mul_n(product.data(), a, padded.data(), n);
+		std::copy(product.begin(), product.begin() + n + m, r);
+		return;
+	}
+
+	// Unbalanced: r = sum over pieces a_i of a_i * b * B^(i*m)
+	LimbBuffer product(2 * m);
+	std::fill(r, r + n + m, 0);
+	for (std::size_t offset = 0; offset < n; offset += m) {
+		std::size_t len = std::min(m, n - offset);
+		mul(product.data(), b, m, a + offset, len);
+		add(r + offset, r + offset, n + m - offset, product.data(), m + len);
+	}
+}
+
+} // namespace limbs
\ No newline at end of file
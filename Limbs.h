@@ -0,0 +1,118 @@
+/** @file Limbs.h
+	@brief Contains the low-level routines that Integer uses on arrays of limbs
+	@author Aviva Prins
+	@date 10/18/2026
+
+	The routines work on natural numbers stored as arrays of 64-bit limbs, least significant limb first. They take
+	raw pointers and lengths so that they can read from and write into any buffer, including the buffer of one of
+	their own operands. Unless a routine says otherwise:
+	1. the result pointer may be equal to an operand pointer (in-place operation), but may not partially overlap it;
+	2. lengths may be zero;
+	3. a routine with two operands of lengths n and m requires n >= m.
+
+	Multiplication chooses its algorithm from the operand sizes: schoolbook below thresholds.mul_karatsuba limbs,
+	Karatsuba below thresholds.mul_toom3 limbs, Toom-3 below thresholds.mul_fft limbs, and three-prime
+	number-theoretic transforms above that. Operands of very different lengths are split into pieces the length of the
+	shorter operand, so that each piece is a balanced product. Squaring has its own entry point, sqr(), so that the
+	transform-based tier only transforms its operand once.
+
+	Division uses a reciprocal-based loop for single-limb divisors, schoolbook division (Knuth's Algorithm D) below
+	thresholds.div_burnikel_ziegler limbs, and Burnikel-Ziegler recursive division above that.
+
+	The innermost loops (carry chains, multiplication by a limb, comparison, the bitwise operations and gcd_n) are
+	chosen at startup from portable, ADX, AVX2 and AVX-512 versions by what the processor supports; see use_kernels().
+
+	Conversion to (and from) decimal divides by (multiplies by) 10^19 repeatedly below thresholds.radix_divide_conquer
+	limbs, and splits the number with cached powers 10^(19*2^k) above that.
+*/
+
+#ifndef LIMBS_H
+#define LIMBS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace limbs {
+
+typedef std::uint64_t limb_t;
+
+// Addition: each returns the carry out of the most significant limb (0 or 1)
+limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n);				  // r[0,n) = a + b
+limb_t add(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m);  // r[0,n) = a + b
+limb_t add_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b);						  // r[0,n) = a + b
+
+// Subtraction: each returns the borrow out of the most significant limb (0 or 1)
+limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n);				  // r[0,n) = a - b
+limb_t sub(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m);  // r[0,n) = a - b
+limb_t sub_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b);						  // r[0,n) = a - b
+
+// Comparison: -1, 0 or 1 as a <, ==, > b
+int cmp_n(const limb_t* a, const limb_t* b, std::size_t n);
+int cmp(const limb_t* a, std::size_t n, const limb_t* b, std::size_t m); // Any lengths; leading zero limbs are allowed
+
+std::size_t normalized_size(const limb_t* a, std::size_t n); // Length of a without its leading zero limbs
+
+// Bitwise operations, limb by limb
+void and_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n); // r[0,n) = a & b
+void ior_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n); // r[0,n) = a | b
+void xor_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n); // r[0,n) = a ^ b
+void com_n(limb_t* r, const limb_t* a, std::size_t n);					 // r[0,n) = ~a
+
+// Lane-wise binary GCD of n independent pairs of words, each below 2^63 (for batches of small fractions); r may be a
+void gcd_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n); // r[i] = gcd(a[i], b[i]); gcd(0, 0) == 0
+
+// Shifts by 0 < bits < 64: each returns the bits shifted out; r may be a (or overlap it in the shift direction)
+limb_t lshift(limb_t* r, const limb_t* a, std::size_t n, unsigned bits); // r[0,n) = a << bits
+limb_t rshift(limb_t* r, const limb_t* a, std::size_t n, unsigned bits); // r[0,n) = a >> bits
+
+// Multiplication by a single limb: each returns the high limb (carry) of the result
+limb_t mul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b);	// r[0,n) = a * b
+limb_t addmul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b); // r[0,n) += a * b
+limb_t submul_1(limb_t* r, const limb_t* a, std::size_t n, limb_t b); // r[0,n) -= a * b (returns the borrow)
+
+/** Size thresholds (in limbs) at which multiplication, division and GCD switch algorithm
+	The defaults suit current x86-64 machines; they can be changed at run time to tune for another machine.
+*/
+struct Thresholds {
+	std::size_t mul_karatsuba = 40; // Smallest balanced size multiplied with Karatsuba
+	std::size_t mul_toom3 = 400;	// Smallest balanced size multiplied with Toom-3
+	std::size_t mul_fft = 2500;		// Smallest size (of the shorter operand) multiplied with NTTs
+	std::size_t div_burnikel_ziegler = 60; // Smallest divisor (and quotient) size divided recursively
+	std::size_t gcd_half = 400;			   // Smallest operand size reduced with the half-GCD (Gcd.cpp)
+	std::size_t radix_divide_conquer = 30; // Smallest size converted to or from decimal by divide and conquer
+};
+extern Thresholds thresholds;
+
+/** Instruction sets with their own versions of the innermost loops (Kernels.cpp)
+	add_n, sub_n, mul_1, addmul_1 and submul_1 have ADX versions; cmp_n, the bitwise operations and gcd_n have AVX2
+	and AVX-512 versions. The best versions this machine supports are chosen at startup.
+*/
+enum class Isa { portable, adx, avx2, avx512 };
+bool host_supports(Isa isa); // True if this machine can run the kernels for isa
+bool use_kernels(Isa isa);	 // Uses only the kernels that need no more than isa (false if the host cannot run isa)
+Isa kernel_isa();			 // The instruction set the kernels are restricted to
+
+// Multiplication: r must not overlap a or b
+void mul(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m);	 // r[0,n+m) = a * b (any n, m)
+void mul_n(limb_t* r, const limb_t* a, const limb_t* b, std::size_t n);				 // r[0,2n) = a * b (balanced)
+void mul_basecase(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m); // Schoolbook, m >= 1
+void sqr(limb_t* r, const limb_t* a, std::size_t n);											 // r[0,2n) = a * a
+
+// Transform-based multiplication (Ntt.cpp): r must not overlap a or b; n, m >= 1
+void mul_fft(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m); // r[0,n+m) = a * b
+void sqr_fft(limb_t* r, const limb_t* a, std::size_t n);								   // r[0,2n) = a * a
+
+// Division (Division.cpp)
+limb_t divrem_1(limb_t* q, const limb_t* a, std::size_t n, limb_t d); // q[0,n) = a / d, returns a % d (q may be a)
+void divrem(limb_t* q, limb_t* r, const limb_t* a, std::size_t n,	  // q[0,n-m+1) = a / d, r[0,m) = a % d
+			const limb_t* d, std::size_t m);						  // (n >= m, d[m-1] != 0, no overlaps)
+
+// Decimal conversion (Radix.cpp)
+std::size_t decimal_size(std::size_t n);							 // Most digits an n-limb number can have
+std::size_t to_decimal(char* out, const limb_t* a, std::size_t n); // Writes the digits of a, returns how many
+std::size_t decimal_limbs(std::size_t len);							  // Most limbs a len-digit number can need
+std::size_t from_decimal(limb_t* r, const char* digits, std::size_t len); // Parses '0'-'9' digits, returns the size
+
+} // namespace limbs
+
+#endif //Ends the include guard
\ No newline at end of file
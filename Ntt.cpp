@@ -0,0 +1,258 @@
+/** @file Ntt.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Multiplication of very large limb arrays with number-theoretic transforms (NTTs).
+
+Each limb is used as one coefficient of a polynomial, and the product polynomial is computed modulo three primes
+p = c*2^k + 1 (k >= 46) with a transform in each. The coefficients of the product are below
+(length) * 2^128 < p1*p2*p3, so the Chinese remainder theorem recovers them exactly, and adding them up with
+carries gives the product. Squaring transforms its single operand once instead of twice.
+*/
+
+#include "LimbBuffer.h"
+#include "Limbs.h"
+
+namespace limbs {
+
+namespace {
+
+/** @class Modulus
+	@brief Arithmetic modulo a prime p < 2^62, using Montgomery multiplication (R = 2^64).
+
+Values are kept in ordinary form; constants that are used as multipliers are kept in Montgomery form, so that
+montgomery(x, to_montgomery(c)) == x * c (mod p) without any conversions of the data itself.
+*/
+class Modulus {
+public:
+	Modulus(limb_t prime, limb_t generator) : p(prime), g(generator) {
+		limb_t inverse = p; // Newton's iteration for p^-1 mod 2^64 (each step doubles the correct bits)
+		for (int i = 0; i < 5; ++i) {
+			inverse *= 2 - p * inverse;
+		}
+		p_neg_inv = limb_t(0) - inverse;
+		limb_t r = (limb_t(0) - p) % p; // 2^64 mod p
+		r2 = (limb_t)(((unsigned __int128)r * r) % p);
+	}
+
+	limb_t add(limb_t a, limb_t b) const {
+		limb_t s = a + b;
+		return (s >= p) ? s - p : s;
+	}
+	limb_t sub(limb_t a, limb_t b) const {
+		return (a >= b) ? a - b : a + p - b;
+	}
+	limb_t montgomery(limb_t a, limb_t b) const { // a * b / 2^64 (mod p)
+		unsigned __int128 t = (unsigned __int128)a * b;
+		limb_t m = (limb_t)t * p_neg_inv;
+		limb_t u = (limb_t)((t + (unsigned __int128)m * p) >> 64);
+		return (u >= p) ? u - p : u;
+	}
+	limb_t to_montgomery(limb_t a) const {
+		return montgomery(a % p, r2);
+	}
+	limb_t mul(limb_t a, limb_t b) const { // a * b (mod p), both in ordinary form
+		return montgomery(montgomery(a, b), r2);
+	}
+	limb_t pow(limb_t a, limb_t e) const {
+		limb_t result = 1;
+		while (e != 0) {
+			if (e & 1) {
+				result = mul(result, a);
+			}
+			a = mul(a, a);
+			e >>= 1;
+		}
+		return result;
+	}
+	limb_t inverse(limb_t a) const {
+		return pow(a, p - 2);
+	}
+
+	limb_t p;		  // The prime
+	limb_t g;		  // A generator of the multiplicative group mod p
+	limb_t p_neg_inv; // -p^-1 mod 2^64
+	limb_t r2;		  // 2^128 mod p
+};
+
+const Modulus moduli[3] = {
+	Modulus(4611615649683210241ull, 11), // 65535 * 2^46 + 1
+	Modulus(4605071356474687489ull, 14), // 32721 * 2^47 + 1
+	Modulus(4601552919265804289ull, 3),  //  4087 * 2^50 + 1
+};
+
+/** @class Transform
+	@brief Forward and inverse NTTs of one power-of-two length modulo one prime.
+
+The forward transform is decimation in frequency and leaves its output in bit-reversed order; the inverse transform
+is decimation in time and takes bit-reversed input. Pointwise products do not depend on the order, so no
+bit-reversal pass is ever needed.
+*/
+class Transform {
+public:
+	Transform(const Modulus& modulus, std::size_t n) : mod(modulus), size(n), roots(n / 2), inverse_roots(n / 2) {
+		limb_t w = mod.pow(mod.g, (mod.p - 1) / n); // Primitive n-th root of unity
+		limb_t w_inv = mod.inverse(w);
+		limb_t x = 1, y = 1;
+		for (std::size_t i = 0; i < n / 2; ++i) {
+			roots[i] = mod.to_montgomery(x);
+			inverse_roots[i] = mod.to_montgomery(y);
+			x = mod.mul(x, w);
+			y = mod.mul(y, w_inv);
+		}
+	}
+
+	void forward(limb_t* a) const {
+		for (std::size_t len = size / 2, stride = 1; len >= 1; len /= 2, stride *= 2) {
+			for (std::size_t i = 0; i < size; i += 2 * len) {
+				for (std::size_t j = 0; j < len; ++j) {
+					limb_t u = a[i + j];
+					limb_t v = a[i + j + len];
+					a[i + j] = mod.add(u, v);
+					a[i + j + len] = mod.montgomery(mod.sub(u, v), roots[j * stride]);
+				}
+			}
+		}
+	}
+
+	void inverse(limb_t* a) const {
+		for (std::size_t len = 1, stride = size / 2; len < size; len *= 2, stride /= 2) {
+			for (std::size_t i = 0; i < size; i += 2 * len) {
+				for (std::size_t j = 0; j < len; ++j) {
+					limb_t u = a[i + j];
+					limb_t v = mod.montgomery(a[i + j + len], inverse_roots[j * stride]);
+					a[i + j] = mod.add(u, v);
+					a[i + j + len] = mod.sub(u, v);
+				}
+			}
+		}
+	}
+
+private:
+	const Modulus& mod;
+	std::size_t size;
+	LimbBuffer roots;		   // w^i in Montgomery form, for i < size/2
+	LimbBuffer inverse_roots; // w^-i in Montgomery form, for i < size/2
+};
+
+/** Computes the cyclic convolution of a and b modulo one prime
+	@param result receives the first length coefficients of a * b (mod p)
+	@param length the number of coefficients wanted
+	@param mod the prime
+	@param size the transform length (a power of two, at least n + m - 1)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs), or nullptr to square a
+*/
+void convolve(limb_t* result, std::size_t length, const Modulus& mod, std::size_t size,
+			  const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	Transform transform(mod, size);
+	LimbBuffer fa(size, 0);
+	for (std::size_t i = 0; i < n; ++i) {
+		fa[i] = a[i] % mod.p;
+	}
+	transform.forward(fa.data());
+
+	if (b == nullptr) { // Squaring: one forward transform
+		for (std::size_t i = 0; i < size; ++i) {
+			fa[i] = mod.montgomery(fa[i], fa[i]);
+		}
+	}
+	else {
+		LimbBuffer fb(size, 0);
+		for (std::size_t i = 0; i < m; ++i) {
+			fb[i] = b[i] % mod.p;
+		}
+		transform.forward(fb.data());
+		for (std::size_t i = 0; i < size; ++i) {
+			fa[i] = mod.montgomery(fa[i], fb[i]);
+		}
+	}
+
+	transform.inverse(fa.data());
+
+	// The pointwise products left a factor of 2^-64; scaling by 2^64 / size removes it and the transform's factor of size
+	limb_t scale = mod.to_montgomery(mod.to_montgomery(mod.inverse(size % mod.p)));
+	for (std::size_t i = 0; i < length; ++i) {
+		result[i] = mod.montgomery(fa[i], scale);
+	}
+}
+
+/** Multiplies (or squares) with three transforms and recombines the coefficients
+	@param r receives a * b (n + m limbs)
+	@param a first operand (n limbs)
+	@param b second operand (m limbs), or nullptr to square a (then m == n)
+*/
+void ntt_mul(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	std::size_t length = n + m - 1; // Number of coefficients in the product
+	std::size_t size = 1;
+	while (size < length) {
+		size *= 2;
+	}
+
+	LimbBuffer residues(3 * length);
+	for (int k = 0; k < 3; ++k) {
+		convolve(residues.data() + k * length, length, moduli[k], size, a, n, b, m);
+	}
+
+	// Garner's constants: p1^-1 (mod p2), (p1*p2)^-1 (mod p3), and p1 (mod p3), in Montgomery form
+	const Modulus& m1 = moduli[0];
+	const Modulus& m2 = moduli[1];
+	const Modulus& m3 = moduli[2];
+	limb_t p1_inv = m2.to_montgomery(m2.inverse(m1.p % m2.p));
+	limb_t p1_mod3 = m3.to_montgomery(m1.p % m3.p);
+	limb_t p12_inv = m3.to_montgomery(m3.inverse(m3.mul(m1.p % m3.p, m2.p % m3.p)));
+	unsigned __int128 p12 = (unsigned __int128)m1.p * m2.p;
+	limb_t p12_low = (limb_t)p12;
+	limb_t p12_high = (limb_t)(p12 >> 64);
+
+	// x = v1 + v2*p1 + v3*p1*p2 for each coefficient, added into a running 3-limb sum
+	limb_t acc0 = 0, acc1 = 0, acc2 = 0;
+	for (std::size_t i = 0; i < n + m; ++i) {
+		if (i < length) {
+			limb_t v1 = residues[i];
+			limb_t v2 = m2.montgomery(m2.sub(residues[length + i], v1 % m2.p), p1_inv);
+			limb_t partial = m3.add(v1 % m3.p, m3.montgomery(v2, p1_mod3)); // v1 + v2*p1 (mod p3)
+			limb_t v3 = m3.montgomery(m3.sub(residues[2 * length + i], partial), p12_inv);
+
+			unsigned __int128 t = (unsigned __int128)v2 * m1.p + v1;				// v1 + v2*p1 (< 2^124)
+			unsigned __int128 low = (unsigned __int128)v3 * p12_low;			// v3*p1*p2 = low + high*2^64
+			unsigned __int128 high = (unsigned __int128)v3 * p12_high;
+			unsigned __int128 s0 = (unsigned __int128)(limb_t)low + (limb_t)t;
+			unsigned __int128 s1 = (low >> 64) + (t >> 64) + (limb_t)high + (limb_t)(s0 >> 64);
+			limb_t x0 = (limb_t)s0;
+			limb_t x1 = (limb_t)s1;
+			limb_t x2 = (limb_t)(s1 >> 64) + (limb_t)(high >> 64); // x < p1*p2*p3 < 2^186
+
+			unsigned __int128 s = (unsigned __int128)acc0 + x0;
+			acc0 = (limb_t)s;
+			s = (unsigned __int128)acc1 + x1 + (limb_t)(s >> 64);
+			acc1 = (limb_t)s;
+			acc2 += x2 + (limb_t)(s >> 64);
+		}
+		r[i] = acc0;
+		acc0 = acc1;
+		acc1 = acc2;
+		acc2 = 0;
+	}
+}
+
+} // namespace
+
+/** Multiplies two arrays with number-theoretic transforms
+	@param r receives a * b (n + m limbs)
+	@param a first operand (n limbs, n >= 1)
+	@param b second operand (m limbs, m >= 1)
+*/
+void mul_fft(limb_t* r, const limb_t* a, std::size_t n, const limb_t* b, std::size_t m) {
+	ntt_mul(r, a, n, b, m);
+}
+
+/** Squares an array with number-theoretic transforms (one forward transform per prime)
+	@param r receives a * a (2n limbs)
+	@param a the operand (n limbs, n >= 1)
+*/
+void sqr_fft(limb_t* r, const limb_t* a, std::size_t n) {
+	ntt_mul(r, a, n, nullptr, n);
+}
+
+} // namespace limbs
\ No newline at end of file
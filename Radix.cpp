@@ -0,0 +1,402 @@
+/** @file Radix.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Conversion of limb arrays (and Integers) to and from text.
+
+Below thresholds.radix_divide_conquer limbs, the number is divided by 10^19 (the largest power of ten that fits in
+a limb) again and again with divrem_1, and each remainder gives 19 digits. That costs O(n^2) single-limb steps.
+
+Larger numbers are split by dividing by a power 10^(19*2^k) of about half their size: the quotient gives the leading
+digits and the remainder exactly 19*2^k trailing digits, and both halves are converted recursively. Division costs
+about as much as multiplication (Burnikel-Ziegler), so the conversion costs O(M(n) log n). The powers are computed by
+repeated squaring once and cached for all later conversions.
+
+Parsing decimal text runs the same way in reverse: short inputs are read 19 digits at a time (multiplying by 10^19
+and adding each chunk), and long inputs are split into leading digits and 19*2^k trailing digits, which are parsed
+recursively and combined as high * 10^(19*2^k) + low. Binary, octal and hexadecimal digits map straight to bits.
+*/
+
+#include "Integer.h"
+#include "LimbBuffer.h"
+#include "Limbs.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace limbs {
+
+namespace {
+
+const limb_t ten_to_19 = 10000000000000000000ull; // The largest power of ten that fits in a limb
+const std::size_t digits_per_limb = 19;
+
+/** Returns the cached power 10^(19*2^k), computing it (and any smaller missing powers) if needed
+	@param k the index of the power
+	@return the limbs of the power, without leading zero limbs
+
+	The cache only grows, and a std::deque never moves its elements when it grows, so the references stay valid.
+*/
+const LimbBuffer& power_of_ten(std::size_t k) {
+	static std::deque<LimbBuffer> powers;
+	static std::mutex mutex;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (powers.empty()) {
+		powers.push_back(LimbBuffer(1, ten_to_19));
+	}
+	while (powers.size() <= k) {
+		const LimbBuffer& last = powers.back();
+		LimbBuffer square(2 * last.size());
+		sqr(square.data(), last.data(), last.size());
+		square.resize(normalized_size(square.data(), square.size()));
+		powers.push_back(std::move(square));
+	}
+	return powers[k];
+}
+
+/** Writes the 19 decimal digits of a limb below 10^19 (with leading zeros)
+	@param out receives the digits
+	@param x the value
+*/
+void write_19_digits(char* out, limb_t x) {
+	for (std::size_t i = digits_per_limb; i-- > 0;) {
+		out[i] = char('0' + x % 10);
+		x /= 10;
+	}
+}
+
+/** Schoolbook conversion: writes exactly width digits of a (with leading zeros), destroying a
+	@param out receives the digits
+	@param width the number of digits (a < 10^width)
+	@param a the value (n limbs; overwritten)
+*/
+void to_decimal_basecase(char* out, std::size_t width, limb_t* a, std::size_t n) {
+	char* end = out + width;
+	n = normalized_size(a, n);
+	while (n > 0) {
+		limb_t chunk = divrem_1(a, a, n, ten_to_19);
+		n = normalized_size(a, n);
+		if (static_cast<std::size_t>(end - out) >= digits_per_limb) {
+			end -= digits_per_limb;
+			write_19_digits(end, chunk);
+		}
+		else { // The leading chunk only has room for its low digits (the rest are zero)
+			while (end > out) {
+				*--end = char('0' + chunk % 10);
+				chunk /= 10;
+			}
+		}
+	}
+	std::fill(out, end, '0');
+}
+
+/** Divide-and-conquer conversion: writes exactly width digits of a (with leading zeros), destroying a
+	@param out receives the digits
+	@param width the number of digits (a < 10^width)
+	@param a the value (n limbs; overwritten)
+*/
+void to_decimal_recursive(char* out, std::size_t width, limb_t* a, std::size_t n) {
+	n = normalized_size(a, n);
+	if (n < std::max<std::size_t>(thresholds.radix_divide_conquer, 2)) {
+		to_decimal_basecase(out, width, a, n);
+		return;
+	}
+
+	// Split at the largest cached power 10^(19*2^k) with at most half the digits
+	std::size_t k = 0;
+	while (digits_per_limb << (k + 1) <= width / 2) {
+		++k;
+	}
+	std::size_t low_width = digits_per_limb << k;
+	const LimbBuffer& power = power_of_ten(k);
+	std::size_t m = power.size();
+	if (n < m || (n == m && cmp_n(a, power.data(), m) < 0)) { // a < 10^low_width: the leading digits are all zero
+		std::fill(out, out + width - low_width, '0');
+		to_decimal_recursive(out + width - low_width, low_width, a, n);
+		return;
+	}
+
+	LimbBuffer q(n - m + 1);
+	LimbBuffer r(m);
+	divrem(q.data(), r.data(), a, n, power.data(), m);
+	to_decimal_recursive(out, width - low_width, q.data(), q.size());
+	to_decimal_recursive(out + width - low_width, low_width, r.data(), m);
+}
+
+/** Reads up to 19 decimal digits into a limb
+	@param digits the digits ('0' to '9')
+	@param len the number of digits (at most 19)
+	@return their value
+*/
+limb_t read_digits(const char* digits, std::size_t len) {
+	limb_t x = 0;
+	for (std::size_t i = 0; i < len; ++i) {
+		x = 10 * x + limb_t(digits[i] - '0');
+	}
+	return x;
+}
+
+/** Schoolbook parsing: reads 19 digits at a time
+	@param r receives the value (needs decimal_limbs(len) limbs)
+	@param digits the digits ('0' to '9')
+	@param len the number of digits
+	@return the size of the value in limbs (without leading zero limbs)
+*/
+std::size_t from_decimal_basecase(limb_t* r, const char* digits, std::size_t len) {
+	std::size_t n = 0;
+	std::size_t chunk = len % digits_per_limb; // The leading chunk takes the odd digits
+	if (chunk == 0) {
+		chunk = digits_per_limb;
+	}
+	for (std::size_t i = 0; i < len; i += chunk, chunk = digits_per_limb) {
+		limb_t x = read_digits(digits + i, chunk);
+		if (n == 0) { // Nothing to scale yet
+			if (x != 0) {
+				r[n++] = x;
+			}
+			continue;
+		}
+		limb_t carry = mul_1(r, r, n, ten_to_19);
+		if (carry) {
+			r[n++] = carry;
+		}
+		if (add_1(r, r, n, x)) {
+			r[n++] = 1;
+		}
+	}
+	return n;
+}
+
+/** Divide-and-conquer parsing
+	@param r receives the value (needs decimal_limbs(len) limbs)
+	@param digits the digits ('0' to '9')
+	@param len the number of digits
+	@return the size of the value in limbs (without leading zero limbs)
+*/
+std::size_t from_decimal_recursive(limb_t* r, const char* digits, std::size_t len) {
+	if (len < digits_per_limb * std::max<std::size_t>(thresholds.radix_divide_conquer, 2)) {
+		return from_decimal_basecase(r, digits, len);
+	}
+
+	// value = high * 10^low_len + low, with low_len = 19*2^k at most half the digits
+	std::size_t k = 0;
+	while (digits_per_limb << (k + 1) <= len / 2) {
+		++k;
+	}
+	std::size_t low_len = digits_per_limb << k;
+	std::size_t high_len = len - low_len;
+	LimbBuffer high(decimal_limbs(high_len));
+	std::size_t hn = from_decimal_recursive(high.data(), digits, high_len);
+	std::size_t ln = from_decimal_recursive(r, digits + high_len, low_len); // The low part goes straight into r
+	if (hn == 0) {
+		return ln;
+	}
+
+	const LimbBuffer& power = power_of_ten(k);
+	std::size_t m = power.size();
+	LimbBuffer product(hn + m);
+	mul(product.data(), power.data(), m, high.data(), hn);
+	std::size_t n = hn + m;
+	std::fill(r + ln, r + n, 0);
+	add(r, product.data(), n, r, ln);
+	return normalized_size(r, n);
+}
+
+} // namespace
+
+/** Returns an upper bound on the number of limbs needed for a decimal number
+	@param len the number of digits
+	@return at least the number of limbs of 10^len - 1
+*/
+std::size_t decimal_limbs(std::size_t len) {
+	return len / digits_per_limb + 1; // 10^19 < 2^64, so 19 digits always fit in one limb
+}
+
+/** Parses decimal digits
+	@param r receives the value (needs decimal_limbs(len) limbs; limbs past the returned size are unspecified)
+	@param digits the digits, most significant first (each '0' to '9'; leading zeros are allowed)
+	@param len the number of digits
+	@return the size of the value in limbs (without leading zero limbs)
+*/
+std::size_t from_decimal(limb_t* r, const char* digits, std::size_t len) {
+	return from_decimal_recursive(r, digits, len);
+}
+
+/** Returns an upper bound on the number of decimal digits of an n-limb number
+	@param n the number of limbs
+	@return at least the number of digits of 2^(64n) - 1
+*/
+std::size_t decimal_size(std::size_t n) {
+	// 64 * log10(2) = 19.2659...
+	return digits_per_limb * n + (n * 2660 + 9999) / 10000 + 1;
+}
+
+/** Converts a limb array to decimal
+	@param out receives the digits, most significant first, without leading zeros (needs decimal_size(n) chars)
+	@param a the value (n limbs; leading zero limbs are allowed)
+	@return the number of digits written ("0" for zero)
+*/
+std::size_t to_decimal(char* out, const limb_t* a, std::size_t n) {
+	n = normalized_size(a, n);
+	if (n == 0) {
+		out[0] = '0';
+		return 1;
+	}
+	std::size_t width = decimal_size(n);
+	LimbBuffer scratch(a, a + n);
+	to_decimal_recursive(out, width, scratch.data(), n);
+
+	std::size_t zeros = 0;
+	while (out[zeros] == '0') {
+		++zeros;
+	}
+	std::memmove(out, out + zeros, width - zeros);
+	return width - zeros;
+}
+
+} // namespace limbs
+
+/** Writes the decimal digits of an Integer into a character buffer (like std::to_chars)
+	@param first the start of the buffer
+	@param last the end of the buffer
+	@param value the Integer
+	@return {end of the digits, std::errc()} on success, or {last, std::errc::value_too_large} if the buffer is too
+	small (the buffer contents are then unspecified)
+*/
+ToCharsResult to_chars(char* first, char* last, const Integer& value) {
+	const LimbBuffer& magnitude = value.magnitude();
+	std::size_t room = static_cast<std::size_t>(last - first);
+	std::size_t sign = value.is_negative() ? 1 : 0;
+	std::size_t bound = sign + limbs::decimal_size(magnitude.size());
+
+	ToCharsResult result;
+	if (room >= bound) { // Convert straight into the buffer
+		if (sign) {
+			*first = '-';
+		}
+		result.ptr = first + sign + limbs::to_decimal(first + sign, magnitude.data(), magnitude.size());
+		result.ec = std::errc();
+		return result;
+	}
+
+	std::string digits = to_string(value);
+	if (digits.size() > room) {
+		result.ptr = last;
+		result.ec = std::errc::value_too_large;
+		return result;
+	}
+	result.ptr = std::copy(digits.begin(), digits.end(), first);
+	result.ec = std::errc();
+	return result;
+}
+
+/** Returns the decimal digits of an Integer
+	@param value the Integer
+	@return "####" if value >= 0, and "-####" if value is negative
+*/
+std::string to_string(const Integer& value) {
+	const LimbBuffer& magnitude = value.magnitude();
+	std::string digits(limbs::decimal_size(magnitude.size()) + 1, '\0');
+	std::size_t sign = 0;
+	if (value.is_negative()) {
+		digits[0] = '-';
+		sign = 1;
+	}
+	digits.resize(sign + limbs::to_decimal(&digits[sign], magnitude.data(), magnitude.size()));
+	return digits;
+}
+
+namespace {
+
+/** Returns the value of a digit in bases up to 36
+	@param c the character ('0' to '9', then 'a' to 'z' or 'A' to 'Z')
+	@return the value of the digit, or 36 if c is not a digit
+*/
+unsigned digit_value(char c) {
+	if (c >= '0' && c <= '9') {
+		return unsigned(c - '0');
+	}
+	if (c >= 'a' && c <= 'z') {
+		return unsigned(c - 'a') + 10;
+	}
+	if (c >= 'A' && c <= 'Z') {
+		return unsigned(c - 'A') + 10;
+	}
+	return 36;
+}
+
+/** Parses digits in a power-of-two base: each digit is a fixed number of bits, so no arithmetic is needed
+	@param digits the digits, most significant first (already checked)
+	@param len the number of digits
+	@param bits the number of bits per digit (1, 3 or 4)
+	@return the magnitude
+*/
+LimbBuffer from_power_of_two_digits(const char* digits, std::size_t len, unsigned bits) {
+	LimbBuffer magnitude;
+	magnitude.resize((len * bits + 63) / 64);
+	std::size_t position = 0; // Bit position of the current digit, starting from the last one
+	for (std::size_t i = len; i-- > 0; position += bits) {
+		Integer::limb_t value = digit_value(digits[i]);
+		std::size_t index = position / 64;
+		unsigned offset = position % 64;
+		magnitude[index] |= value << offset;
+		if (offset + bits > 64) { // The digit straddles two limbs
+			magnitude[index + 1] |= value >> (64 - offset);
+		}
+	}
+	return magnitude;
+}
+
+} // namespace
+
+/** Parses an Integer from a character range (like std::from_chars)
+	@param first the start of the text
+	@param last the end of the text
+	@param value receives the Integer (only changed on success)
+	@param base 2, 8, 10 or 16 (hexadecimal digits may be upper or lower case)
+	@return {first character that is not part of the number, std::errc()} on success, or
+	{first, std::errc::invalid_argument} if the text does not start with a number (or the base is not supported)
+
+	The text is an optional '-' followed by digits; like std::from_chars, it takes no leading whitespace, '+' or
+	base prefix ("0x"). There is no limit on the number of digits.
+*/
+FromCharsResult from_chars(const char* first, const char* last, Integer& value, int base) {
+	FromCharsResult result;
+	result.ptr = first;
+	result.ec = std::errc::invalid_argument;
+	unsigned bits = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
+	if (base != 10 && bits == 0) {
+		return result;
+	}
+
+	const char* p = first;
+	bool negative = false;
+	if (p != last && *p == '-') {
+		negative = true;
+		++p;
+	}
+	const char* digits = p;
+	while (p != last && digit_value(*p) < unsigned(base)) {
+		++p;
+	}
+	std::size_t len = static_cast<std::size_t>(p - digits);
+	if (len == 0) {
+		return result;
+	}
+
+	LimbBuffer magnitude;
+	if (base == 10) {
+		magnitude.resize(limbs::decimal_limbs(len));
+		magnitude.resize(limbs::from_decimal(magnitude.data(), digits, len));
+	}
+	else {
+		magnitude = from_power_of_two_digits(digits, len, bits);
+	}
+	value = Integer::from_magnitude(std::move(magnitude), negative);
+	result.ptr = p;
+	result.ec = std::errc();
+	return result;
+}
@@ -0,0 +1,385 @@
+/** @file Serialization.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+The limbs are written and mapped as they are in memory, so the machine must be little-endian (checked when this
+file is compiled). In a file, each entry starts at a multiple of 8 bytes and its two varints are padded with zeros
+to a multiple of 8 bytes, so that the limbs that follow can be read in place as 64-bit words: the mapping starts
+at a page boundary, and the header and the offset table are whole words.
+
+MappedFractions checks the header and the offset table when it opens a file (offsets in increasing order, at
+multiples of 8, inside the file), and the varints of each entry against the size of the entry when it is read.
+*/
+
+#include "Serialization.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the binary format stores limbs in little-endian order");
+
+namespace {
+
+const char magic[8] = {'F', 'R', 'A', 'C', 'T', 'I', 'O', 'N'};
+const std::uint32_t version = 1;
+const std::size_t header_bytes = 24; // magic, version, 4 bytes of zeros, count
+const std::size_t max_varint = 10;	 // Bytes in the longest varint (of a 64-bit value)
+const std::size_t max_heads = 24;	 // The two varints of a Fraction, padded to a multiple of 8 bytes
+const std::size_t read_chunk = 4096; // Limbs read from a stream at a time
+
+/** Writes a varint
+	@param out room for max_varint bytes
+	@param value
+	@return the number of bytes written
+*/
+std::size_t put_varint(unsigned char* out, std::uint64_t value) {
+	std::size_t n = 0;
+	while (value >= 0x80) {
+		out[n++] = static_cast<unsigned char>(value | 0x80);
+		value >>= 7;
+	}
+	out[n++] = static_cast<unsigned char>(value);
+	return n;
+}
+
+/** Reads a varint from memory
+	@param p the first byte; on return, the byte after the varint
+	@param end the end of the bytes that may be read
+	@param value
+	@return false if the varint runs past end or past 64 bits
+*/
+bool get_varint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value) {
+	value = 0;
+	for (unsigned shift = 0; p != end && shift < 64; shift += 7) {
+		unsigned char byte = *p++;
+		value |= std::uint64_t(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Reads a varint from a stream
+	@param in
+	@param value
+	@return false (with failbit set) if the stream ends or the varint runs past 64 bits
+*/
+bool read_varint(std::istream& in, std::uint64_t& value) {
+	value = 0;
+	for (unsigned shift = 0; shift < 64; shift += 7) {
+		int byte = in.get();
+		if (byte == std::char_traits<char>::eof()) {
+			return false;
+		}
+		value |= std::uint64_t(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return true;
+		}
+	}
+	in.setstate(std::ios::failbit);
+	return false;
+}
+
+/** Reads limbs from a stream, a chunk at a time: the count comes from the stream, so the buffer only grows as limbs
+	actually arrive (a corrupt or truncated count fails instead of allocating for limbs that are not there)
+	@param in
+	@param n the number of limbs (at most what a LimbBuffer can hold)
+	@param limbs
+	@return false (with failbit set) if the stream ends first
+*/
+bool read_limbs(std::istream& in, std::uint64_t n, LimbBuffer& limbs) {
+	if (n > std::uint64_t(UINT32_MAX)) {
+		in.setstate(std::ios::failbit);
+		return false;
+	}
+	limbs.clear();
+	while (limbs.size() < n) {
+		std::size_t have = limbs.size();
+		std::size_t chunk = std::size_t(std::min<std::uint64_t>(n - have, read_chunk));
+		limbs.resize(have + chunk); // Grows the capacity geometrically, so the copies add up to O(n)
+		in.read(reinterpret_cast<char*>(limbs.data() + have), std::streamsize(8 * chunk));
+		if (!in) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Checks that limbs read from a stream are in the form write_binary gives them: no leading zero limb
+	@param limbs
+	@return true if limbs is empty or its most significant limb is nonzero
+*/
+bool canonical(const LimbBuffer& limbs) {
+	return limbs.size() == 0 || limbs[limbs.size() - 1] != 0;
+}
+
+/** Writes the two varints of a Fraction: the numerator's limb count and sign, and the denominator's limb count
+	@param out room for 2 * max_varint bytes
+	@param x
+	@return the number of bytes written
+*/
+std::size_t put_heads(unsigned char* out, const Fraction<Integer>& x) {
+	const Integer& top = x.numerator();
+	std::size_t n = put_varint(out, 2 * std::uint64_t(top.magnitude().size()) + (top.is_negative() ? 1 : 0));
+	return n + put_varint(out + n, x.denominator().magnitude().size());
+}
+
+/** Rounds up to a multiple of 8
+	@param n
+	@return the smallest multiple of 8 that is at least n
+*/
+std::size_t round_up(std::size_t n) {
+	return (n + 7) & ~std::size_t(7);
+}
+
+/** Writes the limbs of |a|, least significant first
+	@param out
+	@param a
+*/
+void write_limbs(std::ostream& out, const Integer& a) {
+	const LimbBuffer& limbs = a.magnitude();
+	out.write(reinterpret_cast<const char*>(limbs.data()), std::streamsize(8 * limbs.size()));
+}
+
+} // namespace
+
+/** Writes an Integer in the binary format: a varint of 2 * limbs + sign, then the limbs
+	@param out
+	@param a
+	@return out
+*/
+std::ostream& write_binary(std::ostream& out, const Integer& a) {
+	unsigned char head[max_varint];
+	std::size_t n = put_varint(head, 2 * std::uint64_t(a.magnitude().size()) + (a.is_negative() ? 1 : 0));
+	out.write(reinterpret_cast<const char*>(head), std::streamsize(n));
+	write_limbs(out, a);
+	return out;
+}
+
+/** Reads an Integer in the binary format
+	@param in
+	@param a is left as it was if there is no Integer to read, or it has a leading zero limb (and failbit is set)
+	@return in
+*/
+std::istream& read_binary(std::istream& in, Integer& a) {
+	std::uint64_t head;
+	LimbBuffer limbs;
+	if (!read_varint(in, head) || !read_limbs(in, head >> 1, limbs) || !canonical(limbs)) {
+		in.setstate(std::ios::failbit);
+		return in;
+	}
+	a = Integer::from_magnitude(std::move(limbs), head & 1);
+	return in;
+}
+
+/** Writes a Fraction<Integer> in the binary format: both varints, then the limbs of the numerator and denominator
+	@param out
+	@param x
+	@return out
+*/
+std::ostream& write_binary(std::ostream& out, const Fraction<Integer>& x) {
+	unsigned char heads[2 * max_varint];
+	std::size_t n = put_heads(heads, x);
+	out.write(reinterpret_cast<const char*>(heads), std::streamsize(n));
+	write_limbs(out, x.numerator());
+	write_limbs(out, x.denominator());
+	return out;
+}
+
+/** Reads a Fraction<Integer> in the binary format (written reduced, so it is not reduced again)
+	@param in
+	@param x is left as it was if there is no Fraction to read, its denominator is zero, or either part has a leading
+	zero limb (and failbit is set)
+	@return in
+*/
+std::istream& read_binary(std::istream& in, Fraction<Integer>& x) {
+	std::uint64_t head;
+	std::uint64_t bottom_size;
+	LimbBuffer top;
+	LimbBuffer bottom;
+	if (!read_varint(in, head) || !read_varint(in, bottom_size) || !read_limbs(in, head >> 1, top) ||
+		!read_limbs(in, bottom_size, bottom) || bottom_size == 0 || !canonical(top) || !canonical(bottom)) {
+		in.setstate(std::ios::failbit);
+		return in;
+	}
+	x = Fraction<Integer>::from_reduced(Integer::from_magnitude(std::move(top), head & 1),
+										 Integer::from_magnitude(std::move(bottom)));
+	return in;
+}
+
+/** Writes a file of Fractions that MappedFractions and load_fractions can read
+	@param path the file (replaced if it exists); throws std::system_error if it cannot be written
+	@param values
+*/
+void save_fractions(const std::string& path, const std::vector<Fraction<Integer>>& values) {
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		throw std::system_error(errno, std::generic_category(), "cannot create " + path);
+	}
+	std::size_t n = values.size();
+	unsigned char header[header_bytes] = {};
+	std::uint64_t entries = n;
+	std::memcpy(header, magic, sizeof magic);
+	std::memcpy(header + 8, &version, sizeof version);
+	std::memcpy(header + 16, &entries, sizeof entries);
+
+	std::vector<std::uint64_t> offsets(n + 1);
+	std::uint64_t at = header_bytes + 8 * (n + 1);
+	unsigned char heads[2 * max_varint];
+	for (std::size_t i = 0; i < n; ++i) {
+		const Fraction<Integer>& x = values[i];
+		offsets[i] = at;
+		std::size_t limbs = x.numerator().magnitude().size() + x.denominator().magnitude().size();
+		at += round_up(put_heads(heads, x)) + 8 * limbs;
+	}
+	offsets[n] = at;
+	out.write(reinterpret_cast<const char*>(header), sizeof header);
+	out.write(reinterpret_cast<const char*>(offsets.data()), std::streamsize(8 * offsets.size()));
+
+	for (const Fraction<Integer>& x : values) {
+		unsigned char padded[max_heads] = {};
+		out.write(reinterpret_cast<const char*>(padded), std::streamsize(round_up(put_heads(padded, x))));
+		write_limbs(out, x.numerator());
+		write_limbs(out, x.denominator());
+	}
+	out.flush();
+	if (!out) {
+		throw std::system_error(std::make_error_code(std::errc::io_error), "cannot write " + path);
+	}
+}
+
+/** Reads a whole file written by save_fractions into memory
+	@param path the file; throws as MappedFractions does if it cannot be read
+	@return the fractions
+*/
+std::vector<Fraction<Integer>> load_fractions(const std::string& path) {
+	MappedFractions file(path);
+	std::vector<Fraction<Integer>> values;
+	values.reserve(file.size());
+	for (std::size_t i = 0; i < file.size(); ++i) {
+		values.push_back(file[i].to_fraction());
+	}
+	return values;
+}
+
+/** Number of bits in the magnitude
+	@return the number of bits in |a| (0 for zero)
+*/
+std::size_t IntegerView::bit_length() const {
+	return count == 0 ? 0 : 64 * count - std::size_t(__builtin_clzll(limbs[count - 1]));
+}
+
+/** Copies the value into an Integer
+	@return the value
+*/
+Integer IntegerView::to_integer() const {
+	LimbBuffer copy;
+	copy.resize(count);
+	std::copy(limbs, limbs + count, copy.data());
+	return Integer::from_magnitude(std::move(copy), negative);
+}
+
+/** Equality: true if lhs == rhs
+	@param lhs
+	@param rhs
+	@return true if both have the same sign and the same limbs
+*/
+bool operator==(const IntegerView& lhs, const IntegerView& rhs) {
+	return lhs.count == rhs.count && lhs.negative == rhs.negative &&
+		   std::equal(lhs.limbs, lhs.limbs + lhs.count, rhs.limbs);
+}
+
+/** Copies the value into a Fraction<Integer>
+	@return the value (reduced, as it was written)
+*/
+Fraction<Integer> FractionView::to_fraction() const {
+	return Fraction<Integer>::from_reduced(top.to_integer(), bottom.to_integer());
+}
+
+/** Constructor: maps a file written by save_fractions
+	@param path the file; throws std::system_error if it cannot be opened or mapped, and std::invalid_argument if it
+	is not a file of Fractions (or not of this version)
+*/
+MappedFractions::MappedFractions(const std::string& path) : base(nullptr), bytes(0), count(0), offsets(nullptr) {
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "cannot open " + path);
+	}
+	struct stat status;
+	if (::fstat(fd, &status) != 0) {
+		int error = errno;
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "cannot read " + path);
+	}
+	bytes = std::size_t(status.st_size);
+	if (bytes < header_bytes + 8) {
+		::close(fd);
+		throw std::invalid_argument(path + " is not a file of fractions");
+	}
+	void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	int error = errno;
+	::close(fd); // The mapping stays valid
+	if (mapping == MAP_FAILED) {
+		throw std::system_error(error, std::generic_category(), "cannot map " + path);
+	}
+	base = static_cast<const unsigned char*>(mapping);
+
+	std::uint32_t file_version;
+	std::uint64_t entries;
+	std::memcpy(&file_version, base + 8, sizeof file_version);
+	std::memcpy(&entries, base + 16, sizeof entries);
+	bool valid = std::memcmp(base, magic, sizeof magic) == 0 && file_version == version &&
+				 entries < (bytes - header_bytes) / 8;
+	if (valid) {
+		count = std::size_t(entries);
+		offsets = reinterpret_cast<const std::uint64_t*>(base + header_bytes);
+		valid = offsets[0] == header_bytes + 8 * (count + 1) && offsets[count] == bytes;
+		for (std::size_t i = 0; valid && i < count; ++i) {
+			valid = offsets[i] <= offsets[i + 1] && offsets[i] % 8 == 0;
+		}
+	}
+	if (!valid) {
+		::munmap(mapping, bytes);
+		throw std::invalid_argument(path + " is not a file of fractions of version " + std::to_string(version));
+	}
+}
+
+/** Destructor: unmaps the file
+*/
+MappedFractions::~MappedFractions() {
+	::munmap(const_cast<unsigned char*>(base), bytes);
+}
+
+/** Reads entry i in place
+	@param i (less than size())
+	@return views of its numerator and denominator, pointing into the mapping
+*/
+FractionView MappedFractions::operator[](std::size_t i) const {
+	const unsigned char* first = base + offsets[i];
+	const unsigned char* last = base + offsets[i + 1];
+	const unsigned char* p = first;
+	std::uint64_t head;
+	std::uint64_t bottom_size;
+	if (get_varint(p, last, head) && get_varint(p, last, bottom_size)) {
+		std::uint64_t top_size = head >> 1;
+		const unsigned char* start = first + round_up(std::size_t(p - first));
+		const IntegerView::limb_t* limbs = reinterpret_cast<const IntegerView::limb_t*>(start);
+		std::uint64_t words = start <= last ? std::uint64_t(last - start) / 8 : 0;
+		if (start <= last && top_size <= words && bottom_size == words - top_size && bottom_size != 0 &&
+			(top_size == 0 || limbs[top_size - 1] != 0) && limbs[words - 1] != 0) {
+			return FractionView(IntegerView(limbs, top_size, (head & 1) && top_size != 0),
+								IntegerView(limbs + top_size, bottom_size, false));
+		}
+	}
+	throw std::invalid_argument("corrupt entry " + std::to_string(i) + " in a file of fractions");
+}
@@ -0,0 +1,174 @@
+/** @file Serialization.h
+	@brief Contains a binary format for Integers and Fractions, and a read-only memory-mapped file of Fractions
+	@author Aviva Prins
+	@date 10/18/2026
+
+	operator<< writes Integers in base 10, which takes a radix conversion for every value written and another for
+	every value read back. The binary format stores the limbs as they are instead (format version 1):
+	1. an Integer is a varint (7 bits a byte, least significant first, high bit set on all but the last byte) holding
+	   2 * (number of limbs) + (1 if negative), followed by the limbs, least significant first, each as 8 bytes
+	   least significant first;
+	2. a Fraction<Integer> is the varint of its numerator, the varint of the number of limbs of its denominator
+	   (which is positive), then the limbs of both.
+	write_binary and read_binary put single values on a stream this way.
+
+	save_fractions writes a whole vector to a file: a header (the bytes "FRACTION", the version, the count), a table
+	of the offset of each entry, and the entries in the format of 2, with the limbs of each entry starting at a
+	multiple of 8 bytes. MappedFractions maps such a file into memory (read only) and gives random access to its
+	entries as FractionViews, whose IntegerViews point at the limbs in the mapping: opening the file reads only
+	the header and checks the offset table, and each value is copied out only if it is asked for (to_integer(),
+	to_fraction()). load_fractions copies all of them, which is one memcpy per part.
+
+	Usage: save_fractions("checkpoint.bin", values);
+	       MappedFractions file("checkpoint.bin");
+	       for (FractionView x : file) { ... x.numerator().size() ... x.to_fraction() ... }
+	       std::vector<Fraction<Integer>> values = load_fractions("checkpoint.bin");
+	The files store the limbs in the byte order of the machine, which must be little-endian. Reading a file back
+	trusts that its fractions were reduced when they were written (they are not reduced again).
+*/
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Fraction.h"
+#include "Integer.h"
+
+std::ostream& write_binary(std::ostream& out, const Integer& a);		   // Writes a in the binary format
+std::istream& read_binary(std::istream& in, Integer& a);				   // Reads a (sets failbit if there is none)
+std::ostream& write_binary(std::ostream& out, const Fraction<Integer>& x); // Writes x in the binary format
+std::istream& read_binary(std::istream& in, Fraction<Integer>& x);		   // Reads x (sets failbit if there is none)
+
+void save_fractions(const std::string& path, const std::vector<Fraction<Integer>>& values); // Writes a file
+std::vector<Fraction<Integer>> load_fractions(const std::string& path); // Reads a file written by save_fractions
+
+/** @class IntegerView
+	@brief An Integer stored elsewhere (such as in a mapped file), read in place: a sign and a pointer to limbs.
+*/
+class IntegerView {
+public:
+	typedef Integer::limb_t limb_t;
+
+	IntegerView() : limbs(nullptr), count(0), negative(false) {} // Zero
+	IntegerView(const limb_t* limbs, std::size_t count, bool negative) // count limbs, the last one nonzero
+		: limbs(limbs), count(count), negative(negative) {}
+
+	const limb_t* data() const { return limbs; } // The limbs of |a|, least significant first
+	std::size_t size() const { return count; }	 // The number of limbs (0 for zero)
+	bool is_negative() const { return negative; }
+	std::size_t bit_length() const; // Number of bits in |a|
+
+	Integer to_integer() const; // A copy of the value
+
+	friend bool operator==(const IntegerView& lhs, const IntegerView& rhs); // True if the values are equal
+	friend bool operator!=(const IntegerView& lhs, const IntegerView& rhs) { return !(lhs == rhs); }
+
+private:
+	const limb_t* limbs;
+	std::size_t count;
+	bool negative;
+};
+
+/** @class FractionView
+	@brief A reduced Fraction<Integer> stored elsewhere, read in place.
+*/
+class FractionView {
+public:
+	FractionView() {} // 0/0 (no value)
+	FractionView(IntegerView numerator, IntegerView denominator) : top(numerator), bottom(denominator) {}
+
+	const IntegerView& numerator() const { return top; }
+	const IntegerView& denominator() const { return bottom; } // Positive
+
+	Fraction<Integer> to_fraction() const; // A copy of the value (not reduced again)
+
+private:
+	IntegerView top;
+	IntegerView bottom;
+};
+
+/** @class MappedFractions
+	@brief A file written by save_fractions, mapped into memory read only, as a random-access range of FractionViews.
+
+The views point into the mapping, so they are only valid while the MappedFractions exists.
+
+*/
+class MappedFractions {
+public:
+	class const_iterator;
+
+	explicit MappedFractions(const std::string& path); // Throws std::system_error or std::invalid_argument
+	~MappedFractions();
+
+	MappedFractions(const MappedFractions&) = delete;
+	MappedFractions& operator=(const MappedFractions&) = delete;
+
+	std::size_t size() const { return count; }
+	FractionView operator[](std::size_t i) const; // Entry i (throws std::invalid_argument if it is corrupt)
+
+	const_iterator begin() const;
+	const_iterator end() const;
+
+private:
+	const unsigned char* base; // The mapping
+	std::size_t bytes;		   // Its length
+	std::size_t count;		   // The number of entries
+	const std::uint64_t* offsets; // count + 1 offsets from base: entry i is [offsets[i], offsets[i + 1])
+};
+
+/** @class MappedFractions::const_iterator
+	@brief A position in a MappedFractions; dereferencing it makes the FractionView of the entry.
+*/
+class MappedFractions::const_iterator {
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef FractionView value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef const FractionView* pointer;
+	typedef FractionView reference; // Made on each access, as for a proxy
+
+	const_iterator() : file(nullptr), i(0) {}
+	const_iterator(const MappedFractions* file, std::size_t i) : file(file), i(i) {}
+
+	FractionView operator*() const { return (*file)[i]; }
+	FractionView operator[](difference_type n) const { return (*file)[i + n]; }
+
+	const_iterator& operator++() { ++i; return *this; }
+	const_iterator& operator--() { --i; return *this; }
+	const_iterator operator++(int) { const_iterator old = *this; ++i; return old; }
+	const_iterator operator--(int) { const_iterator old = *this; --i; return old; }
+	const_iterator& operator+=(difference_type n) { i += n; return *this; }
+	const_iterator& operator-=(difference_type n) { i -= n; return *this; }
+	friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+	friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+	friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+	friend difference_type operator-(const const_iterator& a, const const_iterator& b) {
+		return difference_type(a.i) - difference_type(b.i);
+	}
+
+	friend bool operator==(const const_iterator& a, const const_iterator& b) { return a.i == b.i; }
+	friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a.i != b.i; }
+	friend bool operator<(const const_iterator& a, const const_iterator& b) { return a.i < b.i; }
+	friend bool operator>(const const_iterator& a, const const_iterator& b) { return a.i > b.i; }
+	friend bool operator<=(const const_iterator& a, const const_iterator& b) { return a.i <= b.i; }
+	friend bool operator>=(const const_iterator& a, const const_iterator& b) { return a.i >= b.i; }
+
+private:
+	const MappedFractions* file;
+	std::size_t i;
+};
+
+inline MappedFractions::const_iterator MappedFractions::begin() const {
+	return const_iterator(this, 0);
+}
+
+inline MappedFractions::const_iterator MappedFractions::end() const {
+	return const_iterator(this, count);
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,392 @@
+/** @file Sorting.h
+	@brief Contains sorting, selection (nth element and median) and deduplication of large ranges of Fractions
+	@author Aviva Prins
+	@date 10/18/2026
+
+	std::sort with operator< compares fractions by cross-multiplying (or by a floating-point estimate that has to be
+	computed again on every comparison). These functions compute a key for each fraction once instead: the nearest
+	double to its value, as a 64-bit unsigned integer in the same order. Rounding to nearest never reverses the order
+	of two values, so
+		x < y implies key(x) <= key(y),
+	and sorting by key sorts the range up to runs of equal keys (values within a rounding error of each other, or
+	beyond the range of double). Only those runs are sorted with exact comparisons.
+
+	The keys are computed on a ThreadPool and sorted by a sample sort: a sample of the keys picks splitters between
+	a few buckets per thread; each task counts, then scatters, the keys of its part of the range into the buckets;
+	and each bucket (equal keys always land in the same one) is sorted by a task of its own, exact ties included.
+	The fractions themselves are only moved at the end, into their sorted places.
+
+	Usage: sort_fractions(v.begin(), v.end());
+	       v.erase(unique_fractions(v.begin(), v.end()), v.end()); // Sorted, without duplicates
+	       nth_fraction(v.begin(), v.begin() + k, v.end());         // As std::nth_element
+	       Fraction<Integer> m = median(v.begin(), v.end());
+	The range is read from the pool's threads, so it must not change during the call.
+*/
+
+#ifndef SORTING_H
+#define SORTING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Fraction.h"
+#include "ThreadPool.h"
+
+namespace sorting {
+
+const std::size_t grain = 4096; // Ranges shorter than twice this are sorted on the calling thread
+
+/** @struct Entry
+	@brief The key of one fraction, and its position in the range.
+*/
+struct Entry {
+	std::uint64_t key;
+	std::size_t index;
+};
+
+/** Maps a double to an unsigned integer in the same order (negative values have their bits inverted, the others
+	their sign bit set)
+	@param x (not NaN)
+	@return the key
+*/
+inline std::uint64_t key(double x) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &x, sizeof bits);
+	return (bits >> 63) ? ~bits : bits | (std::uint64_t(1) << 63);
+}
+
+/** The sort key of a fraction
+	@param x
+	@return the key of the nearest double to x
+*/
+template<typename F, typename R>
+std::uint64_t key(const Fraction<F, R>& x) {
+	return key(x.to_double());
+}
+
+/** The pool to use for a range of n values
+	@param n
+	@return ThreadPool::shared(), or null if the range is short enough for the calling thread
+*/
+inline ThreadPool* pool_for(std::size_t n) {
+	return n >= 2 * grain ? &ThreadPool::shared() : nullptr;
+}
+
+/** Runs task(begin, end) on consecutive parts of [0, n), a task per part
+	@param pool the threads to use, or null to run task(0, n) on the calling thread
+	@param n
+	@param task
+*/
+template<typename Task>
+void for_parts(ThreadPool* pool, std::size_t n, Task task) {
+	if (!pool || n < 2 * grain || pool->size() < 2) {
+		task(std::size_t(0), n);
+		return;
+	}
+	std::size_t parts = std::min(n / grain, pool->size());
+	std::vector<std::future<void>> futures;
+	futures.reserve(parts);
+	for (std::size_t i = 0; i < parts; ++i) {
+		std::size_t begin = n * i / parts;
+		std::size_t end = n * (i + 1) / parts;
+		futures.push_back(pool->submit([&task, begin, end] { task(begin, end); }));
+	}
+	ThreadPool::wait_all(futures);
+}
+
+/** Computes the key of each value of a range
+	@param first
+	@param n the number of values
+	@param pool the threads to use, or null
+	@return an entry for each value, in the order of the range
+*/
+template<typename It>
+std::vector<Entry> make_entries(It first, std::size_t n, ThreadPool* pool) {
+	std::vector<Entry> entries(n);
+	for_parts(pool, n, [first, &entries](std::size_t begin, std::size_t end) {
+		It x = std::next(first, begin);
+		for (std::size_t i = begin; i < end; ++i, ++x) {
+			entries[i] = Entry{key(*x), i};
+		}
+	});
+	return entries;
+}
+
+/** Sorts entries by key, then each run of equal keys by the exact order of their values
+	@param first the values
+	@param begin
+	@param end
+*/
+template<typename It>
+void sort_entries(It first, Entry* begin, Entry* end) {
+	std::sort(begin, end, [](const Entry& x, const Entry& y) { return x.key < y.key; });
+	while (begin != end) {
+		Entry* run = begin + 1;
+		while (run != end && run->key == begin->key) {
+			++run;
+		}
+		if (run - begin > 1) {
+			std::sort(begin, run, [first](const Entry& x, const Entry& y) { return first[x.index] < first[y.index]; });
+		}
+		begin = run;
+	}
+}
+
+/** Sorts entries by the exact order of their values, with a sample sort on the pool
+	@param first the values
+	@param entries
+	@param pool the threads to use, or null to sort on the calling thread
+*/
+template<typename It>
+void sort_entries(It first, std::vector<Entry>& entries, ThreadPool* pool) {
+	std::size_t n = entries.size();
+	if (!pool || n < 2 * grain || pool->size() < 2) {
+		sort_entries(first, entries.data(), entries.data() + n);
+		return;
+	}
+
+	std::size_t buckets = 4 * pool->size(); // A few per thread, in case some are larger
+	std::vector<std::uint64_t> sample(16 * buckets);
+	for (std::size_t i = 0; i < sample.size(); ++i) {
+		sample[i] = entries[n * i / sample.size()].key;
+	}
+	std::sort(sample.begin(), sample.end());
+	std::vector<std::uint64_t> splitters(buckets - 1); // Bucket b holds the keys in (splitters[b - 1], splitters[b]]
+	for (std::size_t b = 0; b + 1 < buckets; ++b) {
+		splitters[b] = sample[(b + 1) * sample.size() / buckets];
+	}
+	auto bucket = [&splitters](std::uint64_t k) {
+		return std::size_t(std::lower_bound(splitters.begin(), splitters.end(), k) - splitters.begin());
+	};
+
+	// Part p of the entries puts its keys of bucket b at offsets[p][b] onwards
+	std::size_t parts = std::min(n / grain, pool->size());
+	std::vector<std::vector<std::size_t>> offsets(parts, std::vector<std::size_t>(buckets));
+	std::vector<std::future<void>> futures;
+	futures.reserve(std::max(parts, buckets));
+	for (std::size_t p = 0; p < parts; ++p) {
+		std::vector<std::size_t>* counts = &offsets[p];
+		const Entry* begin = entries.data() + n * p / parts;
+		const Entry* end = entries.data() + n * (p + 1) / parts;
+		futures.push_back(pool->submit([counts, begin, end, &bucket] {
+			for (const Entry* e = begin; e != end; ++e) {
+				++(*counts)[bucket(e->key)];
+			}
+		}));
+	}
+	ThreadPool::wait_all(futures);
+	std::vector<std::size_t> starts(buckets + 1);
+	for (std::size_t b = 0, offset = 0; b < buckets; ++b) {
+		starts[b] = offset;
+		for (std::size_t p = 0; p < parts; ++p) {
+			std::size_t count = offsets[p][b];
+			offsets[p][b] = offset;
+			offset += count;
+		}
+	}
+	starts[buckets] = n;
+
+	std::vector<Entry> scattered(n);
+	futures.clear();
+	for (std::size_t p = 0; p < parts; ++p) {
+		std::vector<std::size_t>* next = &offsets[p];
+		const Entry* begin = entries.data() + n * p / parts;
+		const Entry* end = entries.data() + n * (p + 1) / parts;
+		Entry* out = scattered.data();
+		futures.push_back(pool->submit([next, begin, end, out, &bucket] {
+			for (const Entry* e = begin; e != end; ++e) {
+				out[(*next)[bucket(e->key)]++] = *e;
+			}
+		}));
+	}
+	ThreadPool::wait_all(futures);
+
+	futures.clear();
+	for (std::size_t b = 0; b < buckets; ++b) {
+		Entry* begin = scattered.data() + starts[b];
+		Entry* end = scattered.data() + starts[b + 1];
+		if (end - begin > 1) {
+			futures.push_back(pool->submit([first, begin, end] { sort_entries(first, begin, end); }));
+		}
+	}
+	ThreadPool::wait_all(futures);
+	entries.swap(scattered);
+}
+
+/** Rearranges a range into the order of its entries, moving each value twice
+	@param first
+	@param entries value entries[i].index moves to position i
+	@param pool the threads to use, or null
+*/
+template<typename It>
+void permute(It first, const std::vector<Entry>& entries, ThreadPool* pool) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	std::size_t n = entries.size();
+	std::vector<T> values(n);
+	for_parts(pool, n, [first, &entries, &values](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			values[i] = std::move(first[entries[i].index]);
+		}
+	});
+	for_parts(pool, n, [first, &values](std::size_t begin, std::size_t end) {
+		std::move(values.begin() + begin, values.begin() + end, first + begin);
+	});
+}
+
+/** Selects the entry of the nth value in the exact order of the values, as std::nth_element does
+	@param first the values
+	@param entries; on return, entries[nth] is the nth value, no entry before it is greater and no entry after it
+	is less
+	@param nth
+*/
+template<typename It>
+void select(It first, std::vector<Entry>& entries, std::size_t nth) {
+	auto by_key = [](const Entry& x, const Entry& y) { return x.key < y.key; };
+	std::nth_element(entries.begin(), entries.begin() + nth, entries.end(), by_key);
+	std::uint64_t k = entries[nth].key;
+	// Gather the entries with key k (the values that keys alone cannot order) around nth, then select among them
+	auto low = std::partition(entries.begin(), entries.begin() + nth, [k](const Entry& e) { return e.key < k; });
+	auto high = std::partition(entries.begin() + nth, entries.end(), [k](const Entry& e) { return e.key == k; });
+	std::nth_element(low, entries.begin() + nth, high,
+					 [first](const Entry& x, const Entry& y) { return first[x.index] < first[y.index]; });
+}
+
+/** Moves the entries of duplicate values (after the first of each) to the end
+	@param first the values
+	@param entries sorted by sorting::sort_entries
+	@return the number of distinct values
+*/
+template<typename It>
+std::size_t move_duplicates(It first, std::vector<Entry>& entries) {
+	std::vector<Entry> distinct;
+	std::vector<Entry> duplicates;
+	distinct.reserve(entries.size());
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		// Equal values have equal keys, so only neighbours with equal keys can be duplicates
+		const Entry& e = entries[i];
+		if (i > 0 && e.key == entries[i - 1].key && first[e.index] == first[entries[i - 1].index]) {
+			duplicates.push_back(e);
+		} else {
+			distinct.push_back(e);
+		}
+	}
+	std::size_t n = distinct.size();
+	distinct.insert(distinct.end(), duplicates.begin(), duplicates.end());
+	entries.swap(distinct);
+	return n;
+}
+
+} // namespace sorting
+
+/** Sorts a range of Fractions in increasing order, on the given pool
+	@param first start of the range (random access)
+	@param last end of the range
+	@param pool the threads that do the work
+*/
+template<typename It>
+void sort_fractions(It first, It last, ThreadPool& pool) {
+	std::size_t n = std::size_t(last - first);
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, &pool);
+	sorting::sort_entries(first, entries, &pool);
+	sorting::permute(first, entries, &pool);
+}
+
+/** Sorts a range of Fractions in increasing order, on ThreadPool::shared() (short ranges on the calling thread)
+	@param first start of the range (random access)
+	@param last end of the range
+*/
+template<typename It>
+void sort_fractions(It first, It last) {
+	std::size_t n = std::size_t(last - first);
+	ThreadPool* pool = sorting::pool_for(n);
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, pool);
+	sorting::sort_entries(first, entries, pool);
+	sorting::permute(first, entries, pool);
+}
+
+/** Sorts a range of Fractions and moves one copy of each distinct value to the front, on the given pool
+	@param first start of the range (random access)
+	@param last end of the range
+	@param pool the threads that do the work
+	@return the end of the distinct values, in increasing order (the duplicates follow them)
+*/
+template<typename It>
+It unique_fractions(It first, It last, ThreadPool& pool) {
+	std::size_t n = std::size_t(last - first);
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, &pool);
+	sorting::sort_entries(first, entries, &pool);
+	std::size_t distinct = sorting::move_duplicates(first, entries);
+	sorting::permute(first, entries, &pool);
+	return first + distinct;
+}
+
+/** Sorts a range of Fractions and moves one copy of each distinct value to the front, on ThreadPool::shared()
+	@param first start of the range (random access)
+	@param last end of the range
+	@return the end of the distinct values, in increasing order (the duplicates follow them)
+*/
+template<typename It>
+It unique_fractions(It first, It last) {
+	std::size_t n = std::size_t(last - first);
+	ThreadPool* pool = sorting::pool_for(n);
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, pool);
+	sorting::sort_entries(first, entries, pool);
+	std::size_t distinct = sorting::move_duplicates(first, entries);
+	sorting::permute(first, entries, pool);
+	return first + distinct;
+}
+
+/** Puts the value that a sorted range would have at nth in its place, with no greater value before it and no
+	lesser value after it (as std::nth_element)
+	@param first start of the range (random access)
+	@param nth
+	@param last end of the range
+*/
+template<typename It>
+void nth_fraction(It first, It nth, It last) {
+	std::size_t n = std::size_t(last - first);
+	if (nth == last) {
+		return;
+	}
+	ThreadPool* pool = sorting::pool_for(n);
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, pool);
+	sorting::select(first, entries, std::size_t(nth - first));
+	sorting::permute(first, entries, pool);
+}
+
+/** Median of a range of Fractions (the range is left as it is)
+	@param first start of the range (random access)
+	@param last end of the range; throws std::invalid_argument if the range is empty
+	@return the middle value, or the mean of the two middle values of a range of even length
+*/
+template<typename It>
+typename std::iterator_traits<It>::value_type median(It first, It last) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	std::size_t n = std::size_t(last - first);
+	if (n == 0) {
+		throw std::invalid_argument("median of an empty range");
+	}
+	std::vector<sorting::Entry> entries = sorting::make_entries(first, n, sorting::pool_for(n));
+	sorting::select(first, entries, n / 2);
+	const T& upper = first[entries[n / 2].index];
+	if (n % 2 == 1) {
+		return upper;
+	}
+	// The lower middle value is the greatest of the entries before n / 2
+	const sorting::Entry* lower = &entries[0];
+	for (std::size_t i = 1; i < n / 2; ++i) {
+		const sorting::Entry& e = entries[i];
+		if (e.key > lower->key || (e.key == lower->key && first[lower->index] < first[e.index])) {
+			lower = &e;
+		}
+	}
+	return (first[lower->index] + upper) / T(2);
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,320 @@
+/** @file Summation.h
+	@brief Contains sum and product of a range of Integers or Fractions, computed as a balanced tree on a ThreadPool
+	@author Aviva Prins
+	@date 10/18/2026
+
+	Adding N fractions one after another with += grows the running denominator at every step, so each step works on a
+	result that is already nearly full size and the total cost is close to quadratic in the size of the result.
+	sum(first, last) and product(first, last) combine the values in pairs instead (binary splitting), so that most
+	of the work is on small operands and the large multiplications at the top are balanced (which is where
+	Karatsuba, Toom-Cook and NTT multiplication pay off). In addition:
+	1. the range is split into chunks, each reduced to one value by a task on a ThreadPool, and the chunk results are
+	   combined a level at a time, the pairs of each level in parallel;
+	2. Fractions of unbounded types (such as Integer) are carried through the tree as unreduced numerator and
+	   denominator pairs, with a single reduction (one GCD) at the root;
+	3. the products of each pair of fractions (a*d, c*b and b*d for a/b + c/d) are separate tasks, so that the last
+	   few levels, which hold the largest operands, still use several threads.
+
+	Usage: Fraction<Integer> total = sum(weights.begin(), weights.end());
+	       Integer n_factorial = product(factors.begin(), factors.end());
+	The range is read from the pool's threads, so it must not change during the call. Each value type says how to
+	carry its values through the tree by specializing summation::Tree; the default combines the values themselves
+	with += and *= (which, for Fractions of built-in types, keeps every partial result reduced so that it does not
+	overflow).
+*/
+
+#ifndef SUMMATION_H
+#define SUMMATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Fraction.h"
+#include "ThreadPool.h"
+
+namespace summation {
+
+const std::size_t grain = 1024; // Ranges shorter than twice this are summed on the calling thread
+
+/** Moves nodes[2i] to nodes[i], once each pair has been combined into its first node
+	@param nodes (an odd last node is carried up as it is)
+*/
+template<typename Node>
+void halve(std::vector<Node>& nodes) {
+	std::size_t n = (nodes.size() + 1) / 2;
+	for (std::size_t i = 1; i < n; ++i) {
+		nodes[i] = std::move(nodes[2 * i]);
+	}
+	nodes.resize(n);
+}
+
+/** Combines the nodes in pairs, one task per pair: nodes[2i] and nodes[2i + 1] become nodes[i]
+	@param pool
+	@param nodes (an odd last node is carried up as it is)
+	@param combine combine(x, y) sets x to the sum or product of x and y
+*/
+template<typename Node, typename Combine>
+void combine_pairs(ThreadPool& pool, std::vector<Node>& nodes, Combine combine) {
+	std::size_t pairs = nodes.size() / 2;
+	std::vector<std::future<void>> futures;
+	futures.reserve(pairs);
+	for (std::size_t i = 0; i < pairs; ++i) {
+		Node* x = &nodes[2 * i];
+		futures.push_back(pool.submit([x, combine] { combine(x[0], x[1]); }));
+	}
+	ThreadPool::wait_all(futures);
+	halve(nodes);
+}
+
+/** @struct Tree
+	@brief How sum and product carry values of type T through the tree; the default carries the values themselves.
+
+A specialization provides Node (what the tree holds), leaf (a value as a node), add and multiply (combine two nodes
+into the first), add_pairs and multiply_pairs (combine a level of nodes in pairs on a pool), and value (the result
+at the root).
+*/
+template<typename T, typename Enable = void>
+struct Tree {
+	typedef T Node;
+
+	static Node leaf(const T& x) {
+		return x;
+	}
+
+	static void add(Node& x, const Node& y) {
+		x += y;
+	}
+
+	static void multiply(Node& x, const Node& y) {
+		x *= y;
+	}
+
+	static void add_pairs(ThreadPool& pool, std::vector<Node>& nodes) {
+		combine_pairs(pool, nodes, [](Node& x, const Node& y) { add(x, y); });
+	}
+
+	static void multiply_pairs(ThreadPool& pool, std::vector<Node>& nodes) {
+		combine_pairs(pool, nodes, [](Node& x, const Node& y) { multiply(x, y); });
+	}
+
+	static T value(Node& x) {
+		return std::move(x);
+	}
+};
+
+/** @struct Tree
+	@brief Fractions of unbounded types: the tree holds unreduced numerator/denominator pairs, reduced once at the root.
+*/
+template<typename F, typename R>
+struct Tree<Fraction<F, R>, typename std::enable_if<!std::numeric_limits<F>::is_bounded>::type> {
+	struct Node {
+		F top;
+		F bottom; // Positive
+	};
+
+	static Node leaf(const Fraction<F, R>& x) {
+		return Node{x.numerator(), x.denominator()};
+	}
+
+	static void add(Node& x, const Node& y) {
+		if (x.bottom == y.bottom) { // Same denominator (as for whole numbers): just add the numerators
+			x.top += y.top;
+			return;
+		}
+		x.top *= y.bottom; // a/b + c/d = (a*d + c*b) / (b*d)
+		x.top += y.top * x.bottom;
+		x.bottom *= y.bottom;
+	}
+
+	static void multiply(Node& x, const Node& y) {
+		x.top *= y.top;
+		x.bottom *= y.bottom;
+	}
+
+	/** Adds a level in pairs, with a task for each of the three products of each pair
+		@param pool
+		@param nodes
+	*/
+	static void add_pairs(ThreadPool& pool, std::vector<Node>& nodes) {
+		std::size_t pairs = nodes.size() / 2;
+		std::vector<F> bottoms(pairs);
+		std::vector<bool> same(pairs);
+		std::vector<std::future<void>> futures;
+		futures.reserve(3 * pairs);
+		for (std::size_t i = 0; i < pairs; ++i) {
+			Node* x = &nodes[2 * i];
+			Node* y = x + 1;
+			same[i] = (x->bottom == y->bottom);
+			if (same[i]) {
+				continue;
+			}
+			F* d = &bottoms[i];
+			futures.push_back(pool.submit([x, y] { x->top *= y->bottom; }));
+			futures.push_back(pool.submit([x, y] { y->top *= x->bottom; }));
+			futures.push_back(pool.submit([x, y, d] { *d = x->bottom * y->bottom; }));
+		}
+		ThreadPool::wait_all(futures);
+		for (std::size_t i = 0; i < pairs; ++i) {
+			Node& x = nodes[2 * i];
+			x.top += nodes[2 * i + 1].top;
+			if (!same[i]) {
+				x.bottom = std::move(bottoms[i]);
+			}
+		}
+		halve(nodes);
+	}
+
+	/** Multiplies a level in pairs, with a task for the numerators and one for the denominators of each pair
+		@param pool
+		@param nodes
+	*/
+	static void multiply_pairs(ThreadPool& pool, std::vector<Node>& nodes) {
+		std::size_t pairs = nodes.size() / 2;
+		std::vector<std::future<void>> futures;
+		futures.reserve(2 * pairs);
+		for (std::size_t i = 0; i < pairs; ++i) {
+			Node* x = &nodes[2 * i];
+			Node* y = x + 1;
+			futures.push_back(pool.submit([x, y] { x->top *= y->top; }));
+			futures.push_back(pool.submit([x, y] { x->bottom *= y->bottom; }));
+		}
+		ThreadPool::wait_all(futures);
+		halve(nodes);
+	}
+
+	static Fraction<F, R> value(Node& x) {
+		return Fraction<F, R>(std::move(x.top), std::move(x.bottom)); // The one reduction
+	}
+};
+
+/** Combines n values in a balanced tree on the calling thread
+	@param first the first value
+	@param n the number of values (at least 1)
+	@param combine Tree<T>::add or Tree<T>::multiply
+	@return the node for the n values
+*/
+template<typename T, typename It, typename Combine>
+typename Tree<T>::Node split(It first, std::size_t n, Combine combine) {
+	if (n == 1) {
+		return Tree<T>::leaf(*first);
+	}
+	std::size_t half = n / 2;
+	typename Tree<T>::Node x = split<T>(first, half, combine);
+	typename Tree<T>::Node y = split<T>(std::next(first, half), n - half, combine);
+	combine(x, y);
+	return x;
+}
+
+/** Combines the values of a range: a chunk per task, then the chunk results a level at a time
+	@param first
+	@param last
+	@param pool the threads to use, or null to use only the calling thread
+	@param combine Tree<T>::add or Tree<T>::multiply
+	@param combine_pairs Tree<T>::add_pairs or Tree<T>::multiply_pairs
+	@return the result (the range must not be empty)
+*/
+template<typename T, typename It, typename Combine, typename CombinePairs>
+T reduce(It first, It last, ThreadPool* pool, Combine combine, CombinePairs combine_pairs) {
+	typedef typename Tree<T>::Node Node;
+	std::size_t n = std::size_t(std::distance(first, last));
+	if (!pool || n < 2 * grain || pool->size() < 2) {
+		Node x = split<T>(first, n, combine);
+		return Tree<T>::value(x);
+	}
+
+	std::size_t chunks = std::min(n / grain, 4 * pool->size()); // A few per thread, in case some run slower
+	std::vector<std::future<Node>> futures;
+	futures.reserve(chunks);
+	for (std::size_t i = 0; i < chunks; ++i) {
+		std::size_t begin = n * i / chunks;
+		std::size_t end = n * (i + 1) / chunks;
+		It start = std::next(first, begin);
+		futures.push_back(pool->submit([start, begin, end, combine] { return split<T>(start, end - begin, combine); }));
+	}
+	std::vector<Node> nodes;
+	nodes.reserve(chunks);
+	for (std::future<Node>& f : futures) {
+		f.wait();
+	}
+	for (std::future<Node>& f : futures) {
+		nodes.push_back(f.get());
+	}
+	while (nodes.size() > 1) {
+		combine_pairs(*pool, nodes);
+	}
+	return Tree<T>::value(nodes[0]);
+}
+
+} // namespace summation
+
+/** Sum of a range of values (Integers, Fractions, or anything with += and a constructor from 0), on the given pool
+	@param first start of the range
+	@param last end of the range
+	@param pool the threads that do the work
+	@return the sum (zero for an empty range)
+*/
+template<typename It>
+typename std::iterator_traits<It>::value_type sum(It first, It last, ThreadPool& pool) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	typedef summation::Tree<T> Tree;
+	if (first == last) {
+		return T(0);
+	}
+	return summation::reduce<T>(first, last, &pool, &Tree::add, &Tree::add_pairs);
+}
+
+/** Sum of a range of values, on ThreadPool::shared() (short ranges are summed on the calling thread)
+	@param first start of the range
+	@param last end of the range
+	@return the sum (zero for an empty range)
+*/
+template<typename It>
+typename std::iterator_traits<It>::value_type sum(It first, It last) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	typedef summation::Tree<T> Tree;
+	if (first == last) {
+		return T(0);
+	}
+	bool parallel = std::size_t(std::distance(first, last)) >= 2 * summation::grain;
+	return summation::reduce<T>(first, last, parallel ? &ThreadPool::shared() : nullptr, &Tree::add, &Tree::add_pairs);
+}
+
+/** Product of a range of values, on the given pool
+	@param first start of the range
+	@param last end of the range
+	@param pool the threads that do the work
+	@return the product (one for an empty range)
+*/
+template<typename It>
+typename std::iterator_traits<It>::value_type product(It first, It last, ThreadPool& pool) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	typedef summation::Tree<T> Tree;
+	if (first == last) {
+		return T(1);
+	}
+	return summation::reduce<T>(first, last, &pool, &Tree::multiply, &Tree::multiply_pairs);
+}
+
+/** Product of a range of values, on ThreadPool::shared() (short ranges are multiplied on the calling thread)
+	@param first start of the range
+	@param last end of the range
+	@return the product (one for an empty range)
+*/
+template<typename It>
+typename std::iterator_traits<It>::value_type product(It first, It last) {
+	typedef typename std::iterator_traits<It>::value_type T;
+	typedef summation::Tree<T> Tree;
+	if (first == last) {
+		return T(1);
+	}
+	bool parallel = std::size_t(std::distance(first, last)) >= 2 * summation::grain;
+	return summation::reduce<T>(first, last, parallel ? &ThreadPool::shared() : nullptr, &Tree::multiply,
+								&Tree::multiply_pairs);
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,77 @@
+/** @file ThreadPool.cpp
+	@author Aviva Prins
+	@date 10/18/2026
+
+Worker threads share one queue of tasks, protected by a mutex; each thread takes the oldest task, runs it outside the
+lock, and sleeps on the condition variable when the queue is empty.
+*/
+
+#include "ThreadPool.h"
+
+/** Constructor: starts the threads
+	@param threads the number of threads (0 for one per core, as reported by std::thread::hardware_concurrency)
+*/
+ThreadPool::ThreadPool(std::size_t threads) : stopping(false) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads == 0) { // The number of cores is unknown
+		threads = 1;
+	}
+	workers.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i) {
+		workers.emplace_back([this] { run(); });
+	}
+}
+
+/** Destructor: runs the tasks still queued, then stops and joins the threads
+*/
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	ready.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+/** Returns the pool shared by the parallel algorithms
+	@return a pool with one thread per core, started on the first call
+*/
+ThreadPool& ThreadPool::shared() {
+	static ThreadPool pool;
+	return pool;
+}
+
+/** Waits for every future, then rethrows the first exception a task threw (tasks usually refer to the caller's
+	data, so none may still be running when it returns)
+	@param futures
+*/
+void ThreadPool::wait_all(std::vector<std::future<void>>& futures) {
+	for (std::future<void>& f : futures) {
+		f.wait();
+	}
+	for (std::future<void>& f : futures) {
+		f.get();
+	}
+}
+
+/** Takes tasks from the queue and runs them until the pool stops and the queue is empty
+*/
+void ThreadPool::run() {
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) { // Stopping, with nothing left to do
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task(); // A packaged_task: an exception is stored in its future rather than thrown here
+	}
+}
@@ -0,0 +1,78 @@
+/** @file ThreadPool.h
+	@brief Contains a fixed set of worker threads that run submitted tasks
+	@author Aviva Prins
+	@date 10/18/2026
+
+	The parallel algorithms (sum and product in Summation.h) split their work into tasks and hand them to a
+	ThreadPool, so that threads are started once instead of on every call. ThreadPool::shared() is a pool with one
+	thread per core, started the first time it is used.
+
+	Tasks must not wait for other tasks of the same pool (a pool whose threads are all waiting would never finish);
+	the caller submits a batch of tasks and waits for their futures from outside the pool.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/** @class ThreadPool
+	@brief Runs tasks on a fixed number of threads, in the order they were submitted.
+
+The destructor finishes the tasks already submitted, then joins the threads.
+
+*/
+class ThreadPool {
+public:
+	explicit ThreadPool(std::size_t threads = 0); // 0 picks one thread per core
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	std::size_t size() const { return workers.size(); } // The number of threads
+
+	template<typename Task>
+	std::future<typename std::result_of<Task()>::type> submit(Task task); // Runs task() on one of the threads
+
+	static ThreadPool& shared(); // The pool used when none is given (one thread per core)
+	static void wait_all(std::vector<std::future<void>>& futures); // Waits for all, then rethrows the first exception
+
+private:
+	void run(); // The loop of each worker thread
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable ready; // Signalled when a task is queued, or when the pool is stopping
+	bool stopping;
+};
+
+/** Queues a task
+	@param task a function object taking no arguments
+	@return a future for the task's result (or for the exception it throws)
+*/
+template<typename Task>
+std::future<typename std::result_of<Task()>::type> ThreadPool::submit(Task task) {
+	typedef typename std::result_of<Task()>::type Result;
+	// std::function needs a copyable target, so the packaged_task is shared
+	std::shared_ptr<std::packaged_task<Result()>> job = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+	std::future<Result> result = job->get_future();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back([job] { (*job)(); });
+	}
+	ready.notify_one();
+	return result;
+}
+
+#endif //Ends the include guard
@@ -0,0 +1,59 @@
+/** @file Words.h
+	@brief Contains small routines on 64-bit words (rounding a quotient, mixing a hash) that Integer and Fraction use
+	@author Aviva Prins
+	@date 10/18/2026
+
+	Integer.cpp and Fraction.h each need these, but neither should include the other just for them.
+*/
+
+#ifndef WORDS_H
+#define WORDS_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace words {
+
+/** Rounds a quotient to the nearest double (ties to even), including the subnormal range
+	@param q the top bits of the quotient: 55 or 56 bits (so that there are two bits past the last one kept)
+	@param sticky true if any bits below q are nonzero
+	@param shift the quotient is (q + the bits below it) / 2^shift
+	@param negative the sign of the result
+	@return the correctly rounded quotient (infinity if it is too large for a double)
+*/
+inline double round_quotient(std::uint64_t q, bool sticky, long shift, bool negative) {
+	int bits = std::numeric_limits<std::uint64_t>::digits - __builtin_clzll(q);
+	long exponent = bits - 1 - shift;	// The result is in [2^exponent, 2^(exponent + 1))
+	long precision = (exponent >= -1022) ? 53 : 53 - (-1022 - exponent); // Subnormals keep fewer bits
+	if (precision < 0) { // Below half the smallest subnormal
+		return negative ? -0.0 : 0.0;
+	}
+	int drop = bits - int(precision);
+	std::uint64_t mantissa = q >> drop;
+	std::uint64_t rest = q & ((std::uint64_t(1) << drop) - 1);
+	std::uint64_t half = std::uint64_t(1) << (drop - 1);
+	if (rest > half || (rest == half && (sticky || (mantissa & 1)))) {
+		++mantissa; // May carry to 2^precision, which is still exact
+	}
+	double result = std::ldexp(double(mantissa), int(drop - shift));
+	return negative ? -result : result;
+}
+
+/** Mixes a word into a hash: the high and low halves of the 128-bit product x * k, folded together with xor
+	(every bit of x reaches every bit of the result)
+	@param x
+	@param k an odd constant with about as many one bits as zero bits
+	@return the mixed word
+*/
+inline std::uint64_t hash_mix(std::uint64_t x, std::uint64_t k) {
+	__extension__ typedef unsigned __int128 wide_t;
+	wide_t p = wide_t(x) * k;
+	return std::uint64_t(p) ^ std::uint64_t(p >> 64);
+}
+
+const std::uint64_t hash_constants[2] = {0x9e3779b97f4a7c15ull, 0xd6e8feb86659fd93ull}; // For hash_mix
+
+} // namespace words
+
+#endif //Ends the include guard
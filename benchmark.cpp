@@ -0,0 +1,410 @@
+/** @file benchmark.cpp
+ *  @brief Counts the heap allocations (and measures the time) of each Integer, Fraction and HybridFraction operator,
+ *  and of the FractionArray batch operations, the tree summation, the linear solver, the double conversions, the
+ *  fraction sort, the intern table and the binary checkpoints
+ *  @author Aviva Prins
+ *  @date 10/18/2026
+ *
+ *  Build it with the library sources in place of main.cpp (the "benchmark" task in .vscode/tasks.json), with
+ *  optimization on. Each row shows the limb arrays allocated by one evaluation of the expression
+ *  (Integer::allocations(), which also counts the scratch space of division, Karatsuba, Toom-3, the transforms and
+ *  radix conversion; see LimbBuffer.h), and its time. Other heap blocks are not in the column: the vectors, strings
+ *  and tables that the sort, intern, solver and checkpoint rows build are allocated as well.
+ *  Operands of two limbs or fewer live inside the Integer, so the 1-limb rows should show no allocations, except where
+ *  the result needs three limbs (a << 100, and a*b + c*d, which reserves a limb for the carries).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Fraction.h"
+#include "FractionArray.h"
+#include "HybridFraction.h"
+#include "Integer.h"
+#include "IntegerMatrix.h"
+#include "InternTable.h"
+#include "Serialization.h"
+#include "Sorting.h"
+#include "Summation.h"
+
+namespace {
+
+std::mt19937_64 generator(2017);
+
+/** Makes a random positive Integer of exactly n limbs
+ */
+Integer random_integer(std::size_t n) {
+	LimbBuffer limbs;
+	for (std::size_t i = 0; i < n; ++i) {
+		limbs.push_back(generator() | (i + 1 == n ? 1ull << 63 : 0));
+	}
+	return Integer::from_magnitude(std::move(limbs));
+}
+
+/** Runs an operation repeatedly, then prints its allocations per run and its time per run
+ *  @param name the expression being measured
+ *  @param runs how many times to run it
+ *  @param operation the code being measured; it returns something that depends on the result, so that the
+ *  compiler cannot drop the work
+ */
+template<typename Operation>
+void measure(const std::string& name, int runs, Operation operation) {
+	std::size_t sink = 0;
+	std::size_t before = Integer::allocations();
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < runs; ++i) {
+		sink += operation();
+	}
+	auto stop = std::chrono::steady_clock::now();
+	double allocations = double(Integer::allocations() - before) / runs;
+	double nanoseconds = std::chrono::duration<double, std::nano>(stop - start).count() / runs;
+	std::cout << "  " << std::left << std::setw(26) << name << std::right << std::setw(8) << std::fixed
+			  << std::setprecision(2) << allocations << " allocs" << std::setw(12) << std::setprecision(0)
+			  << nanoseconds << " ns" << ((sink == 1) ? " " : "") << std::endl;
+}
+
+/** Measures the Integer operators on operands of n limbs
+ */
+void integer_operators(std::size_t n, int runs) {
+	std::cout << "Integer, " << n << " limbs" << std::endl;
+	generator.seed(2017); // The same operands however many rows come before
+	const Integer a = random_integer(n);
+	const Integer b = random_integer(n);
+	const Integer c = random_integer(n);
+	const Integer d = random_integer(n);
+	const Integer small = random_integer((n + 1) / 2);
+	const Integer word = random_integer(1);
+	Integer x = a;
+
+	measure("x = a + b", runs, [&] { x = a + b; return x.magnitude().size(); });
+	measure("x = a - b", runs, [&] { x = a - b; return x.magnitude().size(); });
+	measure("x = a * b", runs, [&] { x = a * b; return x.magnitude().size(); });
+	measure("x = a / small", runs, [&] { x = a / small; return x.magnitude().size(); });
+	measure("x = a % small", runs, [&] { x = a % small; return x.magnitude().size(); });
+	measure("x = a*b + c*d", runs, [&] { x = a * b + c * d; return x.magnitude().size(); });
+	measure("x = (a + b) + c", runs, [&] { x = (a + b) + c; return x.magnitude().size(); });
+	measure("x = a + (b + c)", runs, [&] { x = a + (b + c); return x.magnitude().size(); });
+	measure("x = a - (b + c)", runs, [&] { x = a - (b + c); return x.magnitude().size(); });
+	measure("x = -a", runs, [&] { x = -a; return x.magnitude().size(); });
+	measure("x = -(a + b)", runs, [&] { x = -(a + b); return x.magnitude().size(); });
+	measure("x = abs(a - b)", runs, [&] { x = abs(a - b); return x.magnitude().size(); });
+	measure("x = ~(a + b)", runs, [&] { x = ~(a + b); return x.magnitude().size(); });
+	measure("x = (a & b) | c", runs, [&] { x = (a & b) | c; return x.magnitude().size(); });
+	measure("x = a << 100", runs, [&] { x = a << 100; return x.magnitude().size(); });
+	x = a;
+	measure("x += b", runs, [&] { x += b; return x.magnitude().size(); });
+	measure("x -= b", runs, [&] { x -= b; return x.magnitude().size(); });
+	measure("x += a * b", runs / 4 + 1, [&] { x += a * b; return x.magnitude().size(); });
+	measure("addmul(x, a, word)", runs, [&] { addmul(x, a, word); return x.magnitude().size(); });
+	measure("x += 12345", runs, [&] { x += 12345; return x.magnitude().size(); });
+	measure("x = a; x *= 12345", runs, [&] { x = a; x *= 12345; return x.magnitude().size(); });
+	measure("divmod(x, a, 12345)", runs, [&] { return std::size_t(divmod(x, a, 12345)); });
+	x = a;
+	measure("++x", runs, [&] { ++x; return x.magnitude().size(); });
+	measure("x++", runs, [&] { return (x++).magnitude().size(); });
+	measure("y = std::move(x); x = y", runs, [&] {
+		Integer y = std::move(x);
+		x = y;
+		return y.magnitude().size();
+	});
+}
+
+/** Measures the Fraction<Integer> operators on numerators and denominators of n limbs
+ */
+void fraction_operators(std::size_t n, int runs) {
+	std::cout << "Fraction<Integer>, " << n << " limbs" << std::endl;
+	generator.seed(2017); // The same operands however many rows come before
+	typedef Fraction<Integer> Q;
+	const Q p(random_integer(n), random_integer(n));
+	const Q q(random_integer(n), random_integer(n));
+	Q x = p;
+
+	measure("x = p + q", runs, [&] { x = p + q; return std::size_t(x > p); });
+	measure("x = p * q", runs, [&] { x = p * q; return std::size_t(x > p); });
+	measure("x = p / q", runs, [&] { x = p / q; return std::size_t(x > p); });
+	measure("x = -(p + q)", runs, [&] { x = -(p + q); return std::size_t(x > p); });
+	measure("x = (p + q) + p", runs, [&] { x = (p + q) + p; return std::size_t(x > p); });
+	measure("x = p + (q + p)", runs, [&] { x = p + (q + p); return std::size_t(x > p); });
+	x = p;
+	measure("++x", runs, [&] { ++x; return std::size_t(x > p); });
+	measure("x++", runs, [&] { return std::size_t(x++ > p); });
+
+	const Q near_p = p + Q(Integer(1), random_integer(4 * n)); // Agrees with p to far more than 48 bits
+	measure("p < q", runs, [&] { return std::size_t(p < q); });
+	measure("p < near_p", runs, [&] { return std::size_t(p < near_p); });
+}
+
+/** Measures HybridFraction on values that fit in words, and on values that have been promoted to Integers
+ */
+void hybrid_operators(int runs) {
+	std::cout << "HybridFraction" << std::endl;
+	generator.seed(2017);
+	const HybridFraction p(std::int64_t(generator() >> 34), std::int64_t(generator() >> 34) + 1);
+	const HybridFraction q(std::int64_t(generator() >> 34), std::int64_t(generator() >> 34) + 1);
+	const HybridFraction big_p = p / HybridFraction(std::int64_t(1) << 62, 3) / HybridFraction(std::int64_t(1) << 62, 5);
+	HybridFraction x = p;
+
+	measure("x = p + q", runs, [&] { x = p + q; return std::size_t(x > p); });
+	measure("x = p * q", runs, [&] { x = p * q; return std::size_t(x > p); });
+	measure("x = p / q", runs, [&] { x = p / q; return std::size_t(x > p); });
+	measure("p < q", runs, [&] { return std::size_t(p < q); });
+	measure("x = big_p + q", runs / 10 + 1, [&] { x = big_p + q; return std::size_t(x.is_small()); });
+	x = p;
+	measure("++x", runs, [&] { ++x; return std::size_t(x.is_small()); });
+}
+
+/** Measures element-wise operations on n small fractions, as a std::vector<Fraction<int>> and as a FractionArray
+ */
+void fraction_arrays(std::size_t n, int runs) {
+	std::cout << "FractionArray, " << n << " elements" << std::endl;
+	generator.seed(2017);
+	std::vector<Fraction<int>> p, q, x(n);
+	FractionArray<int> fp, fq, fx;
+	for (std::size_t i = 0; i < n; ++i) { // Small enough that Fraction<int> does not overflow
+		p.push_back(Fraction<int>(int(generator() >> 50) - 8192, int(generator() >> 50) + 1));
+		q.push_back(Fraction<int>(int(generator() >> 50) - 8192, int(generator() >> 50) + 1));
+		fp.push_back(p.back());
+		fq.push_back(q.back());
+	}
+	std::vector<int> order(n);
+
+	measure("x[i] = p[i] + q[i]", runs, [&] {
+		for (std::size_t i = 0; i < n; ++i) {
+			x[i] = p[i] + q[i];
+		}
+		return std::size_t(x[0].numerator());
+	});
+	measure("add(x, p, q)", runs, [&] { add(fx, fp, fq); return std::size_t(fx.numerators()[0]); });
+	measure("x[i] = p[i] * q[i]", runs, [&] {
+		for (std::size_t i = 0; i < n; ++i) {
+			x[i] = p[i] * q[i];
+		}
+		return std::size_t(x[0].numerator());
+	});
+	measure("mul(x, p, q)", runs, [&] { mul(fx, fp, fq); return std::size_t(fx.numerators()[0]); });
+	measure("order[i] = p[i] < q[i]", runs, [&] {
+		for (std::size_t i = 0; i < n; ++i) {
+			order[i] = (p[i] < q[i]);
+		}
+		return std::size_t(order[0]);
+	});
+	measure("compare(order, p, q)", runs, [&] { compare(order, fp, fq); return std::size_t(order[0]); });
+}
+
+/** Measures adding n fractions with += one after another, and with sum() (a tree, with one reduction at the end)
+ */
+void summations(std::size_t n, int runs) {
+	std::cout << "Sum of " << n << " fractions" << std::endl;
+	generator.seed(2017);
+	std::vector<Fraction<Integer>> weights;
+	for (std::size_t i = 0; i < n; ++i) {
+		weights.push_back(Fraction<Integer>(Integer(generator() >> 44), Integer((generator() >> 34) + 1)));
+	}
+
+	measure("x += weights[i]", runs, [&] {
+		Fraction<Integer> x;
+		for (const Fraction<Integer>& w : weights) {
+			x += w;
+		}
+		return std::size_t(x > weights[0]);
+	});
+	measure("sum(first, last)", runs, [&] {
+		return std::size_t(sum(weights.begin(), weights.end()) > weights[0]);
+	});
+}
+
+/** Solves a system by Gaussian elimination on Fractions (every cell update reduces), for comparison with solve()
+ */
+std::vector<Fraction<Integer>> solve_with_fractions(std::vector<Fraction<Integer>> a,
+												   std::vector<Fraction<Integer>> b) {
+	std::size_t n = b.size();
+	for (std::size_t k = 0; k < n; ++k) {
+		std::size_t p = k;
+		while (a[p * n + k] == Fraction<Integer>(0)) {
+			++p;
+		}
+		for (std::size_t j = 0; j < n; ++j) {
+			std::swap(a[p * n + j], a[k * n + j]);
+		}
+		std::swap(b[p], b[k]);
+		for (std::size_t i = k + 1; i < n; ++i) {
+			Fraction<Integer> factor = a[i * n + k] / a[k * n + k];
+			for (std::size_t j = k; j < n; ++j) {
+				a[i * n + j] -= factor * a[k * n + j];
+			}
+			b[i] -= factor * b[k];
+		}
+	}
+	std::vector<Fraction<Integer>> x(n);
+	for (std::size_t i = n; i-- > 0;) {
+		Fraction<Integer> t = b[i];
+		for (std::size_t j = i + 1; j < n; ++j) {
+			t -= a[i * n + j] * x[j];
+		}
+		x[i] = t / a[i * n + i];
+	}
+	return x;
+}
+
+/** Measures solving an n x n system with small random entries, on Fractions and with Bareiss elimination
+ */
+void linear_systems(std::size_t n, int runs) {
+	std::cout << "Linear system, " << n << " x " << n << std::endl;
+	generator.seed(2017);
+	IntegerMatrix a(n, n);
+	std::vector<Integer> b(n);
+	std::vector<Fraction<Integer>> fa(n * n);
+	std::vector<Fraction<Integer>> fb(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		for (std::size_t j = 0; j < n; ++j) {
+			a(i, j) = Integer(std::int64_t(generator() % 2001) - 1000);
+			fa[i * n + j] = Fraction<Integer>(a(i, j));
+		}
+		b[i] = Integer(std::int64_t(generator() % 2001) - 1000);
+		fb[i] = Fraction<Integer>(b[i]);
+	}
+
+	measure("elimination on Fractions", runs, [&] { return solve_with_fractions(fa, fb).size(); });
+	measure("solve(a, b) (Bareiss)", runs, [&] { return solve(a, b).size(); });
+	measure("determinant(a)", runs, [&] { return determinant(a).bit_length(); });
+}
+
+/** Measures converting between fractions and doubles
+ */
+void conversions(int runs) {
+	std::cout << "Conversions" << std::endl;
+	generator.seed(2017);
+	const double d = double(generator() >> 11) / double(generator() >> 20);
+	const Fraction<long long> f(std::int64_t(generator() >> 2), std::int64_t(generator() >> 2));
+	const Fraction<Integer> big(random_integer(8), random_integer(7));
+
+	measure("Fraction<long long>(d)", runs, [&] { return std::size_t(Fraction<long long>(d).denominator()); });
+	measure("f.to_double()", runs, [&] { return std::size_t(f.to_double() > 1); });
+	measure("big.to_double()", runs, [&] { return std::size_t(big.to_double() > 1); });
+	measure("f.limit_denominator(1000)", runs, [&] { return std::size_t(f.limit_denominator(1000).denominator()); });
+}
+
+/** Measures sorting n fractions with std::sort (comparing with operator<) and with sort_fractions (by key), each on
+ *  a copy of the same values
+ */
+template<typename F>
+void sortings(const std::string& type, std::size_t n, int runs) {
+	std::cout << "Sort of " << n << " " << type << std::endl;
+	generator.seed(2017);
+	std::vector<Fraction<F>> values;
+	for (std::size_t i = 0; i < n; ++i) {
+		values.push_back(Fraction<F>(F(int(generator() >> 34)), F(int(generator() >> 40) + 1)));
+	}
+
+	measure("std::sort", runs, [&] {
+		std::vector<Fraction<F>> v = values;
+		std::sort(v.begin(), v.end());
+		return std::size_t(v[0] < v[n - 1]);
+	});
+	measure("sort_fractions", runs, [&] {
+		std::vector<Fraction<F>> v = values;
+		sort_fractions(v.begin(), v.end());
+		return std::size_t(v[0] < v[n - 1]);
+	});
+	measure("median", runs, [&] { return std::size_t(median(values.begin(), values.end()) < values[0]); });
+}
+
+/** Measures hashing and interning a Fraction<Integer> of n-limb parts that the table already holds
+ */
+void interning(std::size_t n, int runs) {
+	std::cout << "Intern table, " << n << " limbs" << std::endl;
+	generator.seed(2017);
+	const Fraction<Integer> p(random_integer(n), random_integer(n));
+	InternTable<Fraction<Integer>> table;
+	for (int i = 0; i < 1000; ++i) {
+		table.intern(Fraction<Integer>(random_integer(n), random_integer(n)));
+	}
+	table.intern(p);
+
+	measure("std::hash<Integer>", runs, [&] { return std::hash<Integer>()(p.numerator()); });
+	measure("std::hash<Fraction>", runs, [&] { return std::hash<Fraction<Integer>>()(p); });
+	measure("table.intern(p)", runs, [&] { return std::size_t(table.intern(p) != nullptr); });
+}
+
+/** Measures saving and reloading n fractions of 8-limb parts as text (base 10, reduced again when read) and in the
+ *  binary format (through a stream, and as a file mapped by load_fractions)
+ */
+void checkpoints(std::size_t n, int runs) {
+	std::cout << "Checkpoint of " << n << " fractions, 8 limbs" << std::endl;
+	generator.seed(2017);
+	std::vector<Fraction<Integer>> values;
+	for (std::size_t i = 0; i < n; ++i) {
+		values.push_back(Fraction<Integer>(random_integer(8), random_integer(8)));
+	}
+	std::string text;
+	std::string binary;
+	const std::string path = "benchmark_checkpoint.bin";
+
+	measure("text out", runs, [&] {
+		std::ostringstream out;
+		for (const Fraction<Integer>& x : values) {
+			out << x.numerator() << ' ' << x.denominator() << ' ';
+		}
+		text = out.str();
+		return text.size();
+	});
+	measure("text in", runs, [&] {
+		std::istringstream in(text);
+		Fraction<Integer> x;
+		for (std::size_t i = 0; i < n; ++i) {
+			in >> x;
+		}
+		return std::size_t(x > values[0]);
+	});
+	measure("write_binary", runs, [&] {
+		std::ostringstream out;
+		for (const Fraction<Integer>& x : values) {
+			write_binary(out, x);
+		}
+		binary = out.str();
+		return binary.size();
+	});
+	measure("read_binary", runs, [&] {
+		std::istringstream in(binary);
+		Fraction<Integer> x;
+		for (std::size_t i = 0; i < n; ++i) {
+			read_binary(in, x);
+		}
+		return std::size_t(x > values[0]);
+	});
+	measure("save_fractions", runs, [&] {
+		save_fractions(path, values);
+		return values.size();
+	});
+	measure("load_fractions", runs, [&] { return load_fractions(path).size(); });
+	std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+	integer_operators(1, 200000);
+	integer_operators(4, 100000);
+	integer_operators(100, 2000);
+	fraction_operators(1, 20000);
+	fraction_operators(8, 2000);
+	hybrid_operators(200000);
+	fraction_arrays(4096, 200);
+	summations(10000, 2);
+	linear_systems(40, 2);
+	conversions(200000);
+	sortings<long long>("Fraction<long long>", 100000, 5);
+	sortings<Integer>("Fraction<Integer>", 100000, 5);
+	interning(1, 200000);
+	interning(8, 200000);
+	checkpoints(20000, 3);
+	return 0;
+}
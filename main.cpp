@@ -5,8 +5,16 @@
 */
 
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include "Fraction.h"
+#include "FractionArray.h"
+#include "HybridFraction.h"
 #include "Integer.h"
+#include "InternTable.h"
+#include "Serialization.h"
+#include "Sorting.h"
+#include "Summation.h"
 
 int main(){
     Fraction<int> a(1,2);
@@ -22,16 +30,63 @@ int main(){
     Integer y = 2;
     Integer z = 3;
 
-    // Still on the to do list:
-    // Fraction<Integer> c(x,y);
-    // Fraction<Integer> d(z,y);
-    // a = c;
-    // b = d;
-    // std::cout << a+b << std::endl;
-    // std::cout << a-b << std::endl;
-    // std::cout << a*b << std::endl;
-    // std::cout << a/b << std::endl;
-    // std::cout << (a>b) << std::endl;
-    // std::cout << (a<b) << std::endl;
+    Fraction<Integer> c(x,y);
+    Fraction<Integer> d(z,y);
+    std::cout << c+d << std::endl;
+    std::cout << c-d << std::endl;
+    std::cout << c*d << std::endl;
+    std::cout << c/d << std::endl;
+    std::cout << (c>d) << std::endl;
+    std::cout << (c<d) << std::endl;
+
+    HybridFraction e(1, 3000000000);
+    HybridFraction f(1, 4000000001);
+    std::cout << e+f << std::endl;              // The denominator passes 2^63: promoted to Fraction<Integer>
+    std::cout << (e+f).is_small() << std::endl;
+    std::cout << (e+f)-f << std::endl;          // Fits in words again
+    std::cout << (e<f) << std::endl;
+
+    FractionArray<int> g(2);
+    FractionArray<int> h(2);
+    g[0] = a;
+    g[1] = b;
+    h[0] = b;
+    h[1] = Fraction<int>(2,3);
+    add(g, g, h);                               // Both sums, reduced in one batch
+    std::cout << g[0] << " " << g[1] << std::endl;
+
+    std::vector<Fraction<Integer>> harmonic;
+    for (int i = 1; i <= 10; ++i) {
+        harmonic.push_back(Fraction<Integer>(Integer(1), Integer(i)));
+    }
+    std::cout << sum(harmonic.begin(), harmonic.end()) << std::endl; // 1/1 + 1/2 + ... + 1/10, reduced once
+
+    Fraction<long long> tenth(0.1);                      // The exact value of the double 0.1
+    std::cout << tenth << std::endl;
+    std::cout << tenth.limit_denominator(100) << std::endl; // 1/10
+    std::cout << (tenth.to_double() == 0.1) << std::endl;
+
+    sort_fractions(harmonic.begin(), harmonic.end());    // 1/10 first
+    std::cout << harmonic[0] << " " << median(harmonic.begin(), harmonic.end()) << std::endl;
+
+    InternTable<Fraction<Integer>> table;
+    const Fraction<Integer>* half = table.intern(Fraction<Integer>(Integer(1), Integer(2)));
+    std::cout << (table.intern(Fraction<Integer>(Integer(-3), Integer(-6))) == half) << std::endl; // One copy of 1/2
+
+    std::stringstream checkpoint;
+    write_binary(checkpoint, harmonic[9]);                // Limbs as they are, not base 10
+    Fraction<Integer> restored;
+    read_binary(checkpoint, restored);
+    std::cout << restored << std::endl;                  // 1
+
+    std::istringstream truncated(std::string("\xfe\xff\xff\xff\x1f", 5)); // Claims 2^32 - 1 limbs, has none
+    Integer missing;
+    read_binary(truncated, missing);                     // Fails without allocating for the claimed limbs
+    std::cout << truncated.fail() << std::endl;          // 1
+
+    std::string zero_limb("\x02\x01\x01\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 18); // 1 / (a zero limb)
+    std::istringstream padded(zero_limb);
+    read_binary(padded, restored);                       // Rejected rather than read as 1/0
+    std::cout << padded.fail() << " " << restored << std::endl; // 1 1
     return 0;
 }
\ No newline at end of file